@@ -0,0 +1,165 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace svm {
+
+    // Collects single-sample prediction requests from any number of threads
+    // into micro-batches which a pool of workers evaluates via
+    // Model::predict_batch. A batch is dispatched once it is full or once its
+    // oldest request has waited for the latency window. Micro-batching only
+    // pays off for compiled models (cf. Model::compile), which evaluate a
+    // batch by matrix multiplication; compile the model before handing it
+    // to the scheduler, otherwise each sample is evaluated on its own.
+    template <class Model>
+    class batch_scheduler {
+    public:
+        typedef Model model_type;
+        typedef typename Model::input_container_type input_container_type;
+        typedef typename Model::label_type label_type;
+        typedef typename Model::decision_type decision_type;
+        typedef std::pair<label_type, decision_type> result_type;
+        typedef std::chrono::steady_clock clock_type;
+
+        batch_scheduler (Model const& model,
+                         size_t nr_workers = std::thread::hardware_concurrency(),
+                         std::chrono::microseconds latency = std::chrono::microseconds(200),
+                         size_t max_batch_size = 64)
+            : model(model)
+            , latency(latency)
+            , max_batch_size(std::max<size_t>(max_batch_size, 1))
+        {
+            nr_workers = std::max<size_t>(nr_workers, 1);
+            workers.reserve(nr_workers);
+            for (size_t i = 0; i < nr_workers; ++i)
+                workers.emplace_back([this] { work(); });
+        }
+
+        batch_scheduler (batch_scheduler const&) = delete;
+        batch_scheduler & operator= (batch_scheduler const&) = delete;
+
+        // completes all pending requests before returning; requests
+        // submitted once the destruction has begun are rejected
+        ~batch_scheduler () {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto & w : workers)
+                w.join();
+        }
+
+        std::future<result_type> submit (input_container_type x) {
+            std::promise<result_type> promise;
+            auto future = promise.get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping)
+                    throw std::logic_error("batch_scheduler is shutting down");
+                queue.push_back({std::move(x), std::move(promise), clock_type::now()});
+            }
+            cv.notify_one();
+            return future;
+        }
+
+        size_t nr_workers () const { return workers.size(); }
+
+    private:
+        struct request {
+            input_container_type x;
+            std::promise<result_type> promise;
+            clock_type::time_point arrival;
+        };
+
+        void work () {
+            auto ws = model.workspace();
+            std::vector<request> batch;
+            std::vector<input_container_type> xs;
+            std::vector<label_type> labels;
+            std::vector<decision_type> decisions;
+            batch.reserve(max_batch_size);
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [this] { return stopping || !queue.empty(); });
+                    if (queue.empty())
+                        return;
+                    if (!stopping && queue.size() < max_batch_size)
+                        cv.wait_until(lock, queue.front().arrival + latency, [this] {
+                            return stopping || queue.empty() || queue.size() >= max_batch_size;
+                        });
+                    // another worker may have taken the requests meanwhile
+                    if (queue.empty())
+                        continue;
+                    size_t n = std::min(queue.size(), max_batch_size);
+                    for (size_t i = 0; i < n; ++i) {
+                        batch.push_back(std::move(queue.front()));
+                        queue.pop_front();
+                    }
+                    if (!queue.empty())
+                        cv.notify_one();
+                }
+
+                // promises before `done` are satisfied already
+                size_t done = 0;
+                try {
+                    for (auto & r : batch)
+                        xs.push_back(std::move(r.x));
+                    labels.resize(xs.size());
+                    decisions.resize(xs.size());
+                    model.predict_batch(xs.begin(), xs.end(),
+                                        labels.begin(), decisions.begin(), ws);
+                    for (; done < batch.size(); ++done)
+                        batch[done].promise.set_value({labels[done], std::move(decisions[done])});
+                } catch (...) {
+                    for (size_t i = done; i < batch.size(); ++i)
+                        batch[i].promise.set_exception(std::current_exception());
+                }
+                batch.clear();
+                xs.clear();
+            }
+        }
+
+        Model const& model;
+        std::chrono::microseconds latency;
+        size_t max_batch_size;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<request> queue;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+
+}
@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 #include <svm/libsvm/svm.h>
@@ -81,6 +84,59 @@ namespace svm {
             int index;
         };
 
+        // visits the nonzero components only, yielding their position
+        // (counted from the start index, as for const_iterator) and value
+        class nonzero_iterator {
+        public:
+            typedef std::ptrdiff_t difference_type;
+            typedef std::pair<size_t, double> value_type;
+            typedef value_type const * pointer;
+            typedef value_type reference;
+            typedef std::input_iterator_tag iterator_category;
+
+            nonzero_iterator (struct svm_node const * ptr, int start_index)
+                : ptr(ptr), start_index(start_index) {}
+
+            nonzero_iterator & operator++ () {
+                ++ptr;
+                return *this;
+            }
+
+            nonzero_iterator operator++ (int) {
+                nonzero_iterator old(*this);
+                ++(*this);
+                return old;
+            }
+
+            value_type operator* () const {
+                return value_type(ptr->index - start_index, ptr->value);
+            }
+
+            bool is_end () const {
+                return !ptr || ptr->index == -1;
+            }
+
+            friend bool operator== (nonzero_iterator lhs, nonzero_iterator rhs) {
+                if (lhs.is_end() && rhs.is_end())
+                    return true;
+                return lhs.ptr == rhs.ptr;
+            }
+
+            friend bool operator!= (nonzero_iterator lhs, nonzero_iterator rhs) {
+                return !(lhs == rhs);
+            }
+
+        private:
+            struct svm_node const * ptr;
+            int start_index;
+        };
+
+        struct nonzero_range {
+            nonzero_iterator begin () const { return first; }
+            nonzero_iterator end () const { return nonzero_iterator(nullptr, -1); }
+            nonzero_iterator first;
+        };
+
         data_view ()
             : begin_ptr(nullptr), start_index(-1) {}
 
@@ -99,21 +155,105 @@ namespace svm {
             return const_iterator(nullptr, -1);
         }
 
+        nonzero_range nonzeros () const {
+            if (start_index == -1)
+                return { nonzero_iterator(nullptr, -1) };
+            return { nonzero_iterator(begin_ptr, start_index) };
+        }
+
         double front () const {
             return *begin();
         }
 
+        struct svm_node const * ptr () const {
+            return begin_ptr;
+        }
+
+        // runs over the nonzeros only; views whose indices are contiguous
+        // from the start index are multiplied as dense vectors
         double dot (data_view other) const {
-            data_view::const_iterator lhs = begin();
-            data_view::const_iterator rhs = other.begin();
+            if (start_index == -1 || other.start_index == -1)
+                return 0.;
+            size_t n, m;
+            bool dense = contiguous(n);
+            bool other_dense = other.contiguous(m);
+            if (dense && other_dense)
+                return dense_dot(begin_ptr, other.begin_ptr, std::min(n, m));
+            if (dense)
+                return other.scatter_dot(begin_ptr, n);
+            if (other_dense)
+                return scatter_dot(other.begin_ptr, m);
+
             double sum = 0;
-            for (; lhs != end() && rhs != other.end(); ++lhs, ++rhs) {
-                sum += *lhs * *rhs;
+            struct svm_node const * x = begin_ptr;
+            struct svm_node const * y = other.begin_ptr;
+            while (x->index != -1 && y->index != -1) {
+                int i = x->index - start_index;
+                int j = y->index - other.start_index;
+                if (i == j)
+                    sum += (x++)->value * (y++)->value;
+                else if (i < j)
+                    ++x;
+                else
+                    ++y;
+            }
+            return sum;
+        }
+
+        // dot product with the dense vector x of length n
+        double dot (double const * x, size_t n) const {
+            if (start_index == -1)
+                return 0.;
+            size_t len;
+            if (contiguous(len)) {
+                double sum = 0;
+                len = std::min(len, n);
+#pragma omp simd reduction(+:sum)
+                for (size_t k = 0; k < len; ++k)
+                    sum += begin_ptr[k].value * x[k];
+                return sum;
+            }
+            double sum = 0;
+            for (struct svm_node const * y = begin_ptr; y->index != -1; ++y) {
+                size_t k = y->index - start_index;
+                if (k < n)
+                    sum += y->value * x[k];
             }
             return sum;
         }
 
     private:
+        // whether the indices run contiguously from the start index, i.e.
+        // the n nodes store the vector densely
+        bool contiguous (size_t & n) const {
+            n = 0;
+            while (begin_ptr[n].index == start_index + int(n))
+                ++n;
+            return begin_ptr[n].index == -1;
+        }
+
+        // dot product with the contiguous nodes x[0:n] by looking up the
+        // nonzeros of this view
+        double scatter_dot (struct svm_node const * x, size_t n) const {
+            double sum = 0;
+            for (struct svm_node const * y = begin_ptr; y->index != -1; ++y) {
+                size_t k = y->index - start_index;
+                if (k < n)
+                    sum += y->value * x[k].value;
+            }
+            return sum;
+        }
+
+        static double dense_dot (struct svm_node const * x,
+                                 struct svm_node const * y, size_t n)
+        {
+            double sum = 0;
+#pragma omp simd reduction(+:sum)
+            for (size_t k = 0; k < n; ++k)
+                sum += x[k].value * y[k].value;
+            return sum;
+        }
+
         struct svm_node const * begin_ptr;
         int start_index;
     };
@@ -122,6 +262,33 @@ namespace svm {
         return lhs.dot(rhs);
     }
 
+    inline double dot (data_view lhs, double const * rhs, size_t n) {
+        return lhs.dot(rhs, n);
+    }
+
+    // forward declaration
+    class dense_dataset;
+
+    // non-owning view of a dense sample living in a caller's buffer
+    class dense_view {
+    public:
+        typedef double const * const_iterator;
+
+        dense_view (double const * data, size_t n)
+            : data_(data), n(n) {}
+
+        dense_view (dense_dataset const& ds); // forward declaration
+
+        double const * data () const { return data_; }
+        size_t size () const { return n; }
+        const_iterator begin () const { return data_; }
+        const_iterator end () const { return data_ + n; }
+
+    private:
+        double const * data_;
+        size_t n;
+    };
+
 
     class dataset {
     public:
@@ -173,6 +340,10 @@ namespace svm {
             return view().end();
         }
 
+        data_view::nonzero_range nonzeros () const {
+            return view().nonzeros();
+        }
+
     private:
         template <typename OutputIterator>
         void nodify (OutputIterator begin, OutputIterator end, bool skip_zeros) {
@@ -190,4 +361,32 @@ namespace svm {
         *this = ds.view();
     }
 
+    // dense sample of a dimension given at runtime, used as the input
+    // container of problems and models of dimension DENSE
+    class dense_dataset : public std::vector<double> {
+    public:
+        dense_dataset () = default;
+
+        template <typename InputIterator>
+        dense_dataset (InputIterator begin, InputIterator end)
+            : std::vector<double>(begin, end) {}
+
+        template <typename Container>
+        dense_dataset (Container const& c)
+            : std::vector<double>(std::begin(c), std::end(c)) {}
+
+        dense_dataset (std::vector<double> && v)
+            : std::vector<double>(std::move(v)) {}
+
+        dense_dataset (std::initializer_list<double> il)
+            : std::vector<double>(il) {}
+
+        dense_view view () const {
+            return dense_view(data(), size());
+        }
+    };
+
+    inline dense_view::dense_view (dense_dataset const& ds)
+        : dense_view(ds.view()) {}
+
 }
@@ -0,0 +1,79 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+
+namespace svm {
+    namespace detail {
+
+        template <typename T, size_t Alignment = 64>
+        struct aligned_allocator {
+            static_assert((Alignment & (Alignment - 1)) == 0
+                          && Alignment >= sizeof(void *),
+                          "invalid alignment");
+
+            using value_type = T;
+
+            template <typename U>
+            struct rebind {
+                using other = aligned_allocator<U, Alignment>;
+            };
+
+            aligned_allocator () = default;
+
+            template <typename U>
+            aligned_allocator (aligned_allocator<U, Alignment> const&) {}
+
+            T * allocate (size_t n) {
+                // over-allocate and stash the original pointer right in
+                // front of the aligned block
+                void * raw = ::operator new(n * sizeof(T) + Alignment);
+                auto addr = reinterpret_cast<std::uintptr_t>(raw) + Alignment;
+                void * aligned = reinterpret_cast<void *>(addr & ~(Alignment - 1));
+                static_cast<void **>(aligned)[-1] = raw;
+                return static_cast<T *>(aligned);
+            }
+
+            void deallocate (T * p, size_t) {
+                ::operator delete(reinterpret_cast<void **>(p)[-1]);
+            }
+
+            template <typename U>
+            friend bool operator== (aligned_allocator const&,
+                                    aligned_allocator<U, Alignment> const&) {
+                return true;
+            }
+
+            template <typename U>
+            friend bool operator!= (aligned_allocator const&,
+                                    aligned_allocator<U, Alignment> const&) {
+                return false;
+            }
+        };
+
+        template <typename T>
+        using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+    }
+}
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <iterator>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -31,8 +32,15 @@
 namespace svm {
     namespace detail {
 
-        template <class Container, class Label>
+        // samples are kept in Storage, which defaults to a vector of
+        // Containers but may hand out views instead (cf. csr_storage)
+        template <class Container, class Label,
+                  class Storage = std::vector<Container>>
         class basic_problem {
+            using sample_view = decltype(std::declval<Storage const&>()[0]);
+            using sample_reference = std::conditional_t<
+                std::is_same<std::decay_t<sample_view>, Container>::value,
+                Container const&, Container>;
         public:
             typedef Container input_container_type;
             typedef Label label_type;
@@ -89,13 +97,9 @@ namespace svm {
 
                 // conditionally copy data accordingly
                 orig_data.reserve(labels.size());
-                auto label_it = transformed_labels.begin();
-                std::copy_if(std::make_move_iterator(other.orig_data.begin()),
-                    std::make_move_iterator(other.orig_data.end()),
-                    std::back_inserter(orig_data),
-                    [&](Container const&) {
-                        return filter(*(label_it++));
-                    });
+                for (size_t i = 0; i < transformed_labels.size(); ++i)
+                    if (filter(transformed_labels[i]))
+                        orig_data.push_back(std::move(other.orig_data[i]));
                 other.orig_data.clear();
             }
 
@@ -106,8 +110,14 @@ namespace svm {
                                });
             }
 
-            std::pair<Container const&, Label> operator[] (size_t i) const {
-                return std::pair<Container const&, Label>(orig_data[i], labels[i]);
+            // storage handing out views materializes the sample as a
+            // Container; use view() to avoid the copy
+            std::pair<sample_reference, Label> operator[] (size_t i) const {
+                return std::pair<sample_reference, Label>(orig_data[i], labels[i]);
+            }
+
+            std::pair<sample_view, Label> view (size_t i) const {
+                return std::pair<sample_view, Label>(orig_data[i], labels[i]);
             }
 
             size_t size () const {
@@ -123,10 +133,10 @@ namespace svm {
                 std::transform(labels.begin(), labels.end(), labels.begin(), map);
             }
 
-            template <class OtherContainer, class OtherLabel>
+            template <class OtherContainer, class OtherLabel, class OtherStorage>
             friend class basic_problem;
         protected:
-            std::vector<Container> orig_data;
+            Storage orig_data;
             std::vector<Label> labels;
         private:
             size_t dimension;
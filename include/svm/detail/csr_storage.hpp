@@ -0,0 +1,73 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <svm/dataset.hpp>
+#include <svm/libsvm/svm.h>
+
+
+namespace svm {
+    namespace detail {
+
+        // sparse samples stored back to back in a single array of nodes, each
+        // row terminated by index -1 as libsvm expects it, and addressed by
+        // row offsets; appending a sample does not allocate per sample
+        class csr_storage {
+        public:
+            void push_back (data_view x) {
+                offsets.push_back(nodes.size());
+                struct svm_node const * node = x.ptr();
+                if (node)
+                    for (; node->index != -1; ++node)
+                        nodes.push_back(*node);
+                nodes.push_back({ .index = -1, .value = {} });
+            }
+
+            data_view operator[] (size_t i) const {
+                return data_view(nodes.data() + offsets[i]);
+            }
+
+            struct svm_node * row (size_t i) {
+                return nodes.data() + offsets[i];
+            }
+
+            size_t size () const {
+                return offsets.size();
+            }
+
+            void reserve (size_t rows) {
+                offsets.reserve(rows);
+            }
+
+            // releases the arena
+            void clear () {
+                nodes = {};
+                offsets = {};
+            }
+
+        private:
+            std::vector<struct svm_node> nodes;
+            std::vector<size_t> offsets;
+        };
+
+    }
+}
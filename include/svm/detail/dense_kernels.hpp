@@ -0,0 +1,77 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <svm/libsvm/svm.h>
+
+
+namespace svm {
+    namespace detail {
+
+        inline double dot (double const * x, double const * y, size_t n) {
+            double sum = 0;
+#pragma omp simd reduction(+:sum)
+            for (size_t i = 0; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        // number of columns needed to hold the samples x[0], ..., x[l-1]
+        // densely; at least dim
+        inline size_t dense_dim (struct svm_node const * const * x, size_t l,
+                                 size_t dim)
+        {
+            for (size_t i = 0; i < l; ++i)
+                for (auto node = x[i]; node->index != -1; ++node)
+                    if (size_t(node->index) > dim)
+                        dim = node->index;
+            return dim;
+        }
+
+        // scatters the sparse sample x into the buffer x_dense (holding at
+        // least cols elements) and returns its squared norm; components beyond
+        // cols only contribute to the norm
+        inline double densify (struct svm_node const * x, double * x_dense,
+                               size_t cols)
+        {
+            std::fill(x_dense, x_dense + cols, 0.);
+            double xx = 0;
+            for (; x->index != -1; ++x) {
+                xx += x->value * x->value;
+                if (size_t(x->index) <= cols)
+                    x_dense[x->index - 1] = x->value;
+            }
+            return xx;
+        }
+
+        inline double powi (double base, int times) {
+            double tmp = base, ret = 1.0;
+            for (int t = times; t > 0; t /= 2) {
+                if (t % 2 == 1)
+                    ret *= tmp;
+                tmp = tmp * tmp;
+            }
+            return ret;
+        }
+
+    }
+}
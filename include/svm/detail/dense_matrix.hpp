@@ -0,0 +1,75 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <svm/detail/aligned_allocator.hpp>
+
+
+namespace svm {
+    namespace detail {
+
+        // row-major matrix of doubles whose rows are padded to full cache
+        // lines, such that each row starts on an aligned address
+        class dense_matrix {
+        public:
+            static const size_t row_alignment = 64 / sizeof(double);
+
+            dense_matrix () : nr_rows(0), nr_cols(0), row_stride(0) {}
+
+            dense_matrix (size_t rows, size_t cols)
+                : nr_rows(rows)
+                , nr_cols(cols)
+                , row_stride((cols + row_alignment - 1) / row_alignment * row_alignment)
+                , data(rows * row_stride, 0.)
+            {
+            }
+
+            bool empty () const {
+                return nr_rows == 0;
+            }
+
+            size_t rows () const {
+                return nr_rows;
+            }
+
+            size_t cols () const {
+                return nr_cols;
+            }
+
+            size_t stride () const {
+                return row_stride;
+            }
+
+            double * row (size_t i) {
+                return &data[i * row_stride];
+            }
+
+            double const * row (size_t i) const {
+                return &data[i * row_stride];
+            }
+
+        private:
+            size_t nr_rows, nr_cols, row_stride;
+            aligned_vector<double> data;
+        };
+
+    }
+}
@@ -0,0 +1,72 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <svm/dataset.hpp>
+
+
+namespace svm {
+    namespace detail {
+
+        // dense samples of equal length stored back to back, i.e. as a
+        // row-major matrix which libsvm trains on directly (svm_train_dense)
+        class dense_storage {
+        public:
+            void push_back (dense_view x) {
+                if (nr_rows == 0)
+                    stride = x.size();
+                else if (x.size() != stride)
+                    throw std::invalid_argument("dense samples differ in dimension");
+                values.insert(values.end(), x.begin(), x.end());
+                ++nr_rows;
+            }
+
+            dense_view operator[] (size_t i) const {
+                return dense_view(values.data() + i * stride, stride);
+            }
+
+            double const * data () const {
+                return values.empty() ? nullptr : values.data();
+            }
+
+            size_t size () const {
+                return nr_rows;
+            }
+
+            void reserve (size_t rows) {
+                values.reserve(rows * stride);
+            }
+
+            void clear () {
+                values = {};
+                nr_rows = 0;
+            }
+
+        private:
+            std::vector<double> values;
+            size_t stride = 0;
+            size_t nr_rows = 0;
+        };
+
+    }
+}
@@ -0,0 +1,125 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <svm/detail/dense_kernels.hpp>
+#include <svm/detail/dense_matrix.hpp>
+#include <svm/libsvm/svm.h>
+
+
+namespace svm {
+    namespace detail {
+
+        // support vectors of a model packed into a dense matrix along with
+        // their squared norms
+        class dense_sv_block {
+        public:
+            dense_sv_block () = default;
+
+            dense_sv_block (struct svm_node const * const * SV, size_t l, size_t dim)
+                : svs(l, dense_dim(SV, l, dim))
+                , norms(l)
+            {
+                for (size_t i = 0; i < l; ++i) {
+                    double * r = svs.row(i);
+                    for (auto node = SV[i]; node->index != -1; ++node)
+                        r[node->index - 1] = node->value;
+                    norms[i] = dot(r, r, svs.cols());
+                }
+            }
+
+            bool empty () const {
+                return svs.empty();
+            }
+
+            size_t rows () const {
+                return svs.rows();
+            }
+
+            size_t cols () const {
+                return svs.cols();
+            }
+
+            size_t stride () const {
+                return svs.stride();
+            }
+
+            double const * row (size_t i) const {
+                return svs.row(i);
+            }
+
+            double norm (size_t i) const {
+                return norms[i];
+            }
+
+            dense_matrix const& matrix () const {
+                return svs;
+            }
+
+            // turns the dot products k[begin:end] of a sample (with squared
+            // norm xx) with the support vectors into the respective kernel
+            // values in place
+            void apply_kernel (struct svm_parameter const& param,
+                               double * k, double xx) const
+            {
+                apply_kernel(param, k, xx, 0, svs.rows());
+            }
+
+            void apply_kernel (struct svm_parameter const& param,
+                               double * k, double xx,
+                               size_t begin, size_t end) const
+            {
+                const size_t l = end - begin;
+                double const * yy = norms.data() + begin;
+                k += begin;
+                const double gamma = param.gamma;
+                const double coef0 = param.coef0;
+                switch (param.kernel_type) {
+                case POLY:
+#pragma omp simd
+                    for (size_t i = 0; i < l; ++i)
+                        k[i] = powi(gamma * k[i] + coef0, param.degree);
+                    break;
+                case RBF:
+#pragma omp simd
+                    for (size_t i = 0; i < l; ++i)
+                        k[i] = std::exp(-gamma * (xx + yy[i] - 2 * k[i]));
+                    break;
+                case SIGMOID:
+#pragma omp simd
+                    for (size_t i = 0; i < l; ++i)
+                        k[i] = std::tanh(gamma * k[i] + coef0);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+        private:
+            dense_matrix svs;
+            std::vector<double> norms;
+        };
+
+    }
+}
@@ -0,0 +1,72 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <svm/detail/dense_kernels.hpp>
+#include <svm/detail/dense_matrix.hpp>
+
+
+namespace svm {
+    namespace detail {
+
+        // C[i][j] = A[i] . B[j] for the first m rows of A and all rows of B.
+        // Rows of B are processed in tiles small enough to stay in cache
+        // while they are reused for all m rows of A, four at a time such that
+        // each element of A is loaded once per four products.
+        inline void gemm_nt (dense_matrix const& A, dense_matrix const& B,
+                             dense_matrix & C, size_t m)
+        {
+            const size_t n = B.rows();
+            const size_t k = std::min(A.cols(), B.cols());
+            const size_t tile = std::max<size_t>(4, (1 << 18) / (B.stride() * sizeof(double)) / 4 * 4);
+            for (size_t jj = 0; jj < n; jj += tile) {
+                const size_t jend = std::min(jj + tile, n);
+                for (size_t i = 0; i < m; ++i) {
+                    double const * a = A.row(i);
+                    double * c = C.row(i);
+                    size_t j = jj;
+                    for (; j + 4 <= jend; j += 4) {
+                        double const * b0 = B.row(j);
+                        double const * b1 = B.row(j + 1);
+                        double const * b2 = B.row(j + 2);
+                        double const * b3 = B.row(j + 3);
+                        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+#pragma omp simd reduction(+:s0,s1,s2,s3)
+                        for (size_t l = 0; l < k; ++l) {
+                            s0 += a[l] * b0[l];
+                            s1 += a[l] * b1[l];
+                            s2 += a[l] * b2[l];
+                            s3 += a[l] * b3[l];
+                        }
+                        c[j] = s0;
+                        c[j + 1] = s1;
+                        c[j + 2] = s2;
+                        c[j + 3] = s3;
+                    }
+                    for (; j < jend; ++j)
+                        c[j] = dot(a, B.row(j), k);
+                }
+            }
+        }
+
+    }
+}
@@ -18,13 +18,17 @@
 
 #pragma once
 
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <svm/dataset.hpp>
+#include <svm/fixed_dataset.hpp>
 #include <svm/detail/always.hpp>
 #include <svm/detail/basic_problem.hpp>
+#include <svm/detail/csr_storage.hpp>
+#include <svm/detail/dense_storage.hpp>
 #include <svm/libsvm/svm.h>
 #include <svm/traits/label_traits.hpp>
 
@@ -32,11 +36,45 @@
 namespace svm {
     namespace detail {
 
-        template <class Label>
-        class patch_through_problem : public basic_problem<dataset, Label> {
+        // sample containers and their storage for dimension Dim
+        template <size_t Dim>
+        struct sample_storage {
+            using container_type = fixed_dataset<Dim>;
+            using storage_type = std::vector<fixed_dataset<Dim>>;
+        };
+
+        template <>
+        struct sample_storage<DYNAMIC> {
+            using container_type = dataset;
+            using storage_type = csr_storage;
+        };
+
+        template <>
+        struct sample_storage<DENSE> {
+            using container_type = dense_dataset;
+            using storage_type = dense_storage;
+        };
+
+        // samples are sparse datasets, kept in a single CSR arena, or dense
+        // datasets of the problem's dimension (Dim == DENSE), or
+        // fixed_datasets when the dimension Dim is known at compile time;
+        // dense samples are kept as one row-major matrix
+        template <class Label, size_t Dim = DYNAMIC>
+        class patch_through_problem
+            : public basic_problem<typename sample_storage<Dim>::container_type,
+                                   Label,
+                                   typename sample_storage<Dim>::storage_type>
+        {
+            using container_type = typename sample_storage<Dim>::container_type;
+            using storage_type = typename sample_storage<Dim>::storage_type;
+            using base_type = basic_problem<container_type, Label, storage_type>;
         public:
             static bool const is_precomputed = false;
-            patch_through_problem(size_t dim) : basic_problem<dataset, Label>(dim) {};
+            patch_through_problem(size_t dim) : base_type(dim) {
+                if (is_fixed_dim(Dim) && dim != Dim)
+                    throw std::invalid_argument("dimension does not match "
+                                                "fixed dimension of problem");
+            };
             patch_through_problem(patch_through_problem const&) = delete;
             patch_through_problem & operator= (patch_through_problem const&) = delete;
             patch_through_problem(patch_through_problem &&) = default;
@@ -48,19 +86,47 @@ namespace svm {
             patch_through_problem(OtherProblem && other,
                                   UnaryFunction map,
                                   UnaryPredicate filter = {})
-                : basic_problem<dataset, Label>(std::move(other), map, filter)
+                : base_type(std::move(other), map, filter)
             {
             }
 
+            void add_sample (container_type && ds, Label label) {
+                check_dim(ds);
+                base_type::add_sample(std::move(ds), label);
+            }
+
+            void add_sample (container_type const& ds, Label label) {
+                check_dim(ds);
+                base_type::add_sample(ds, label);
+            }
+
             template <typename ..., typename L = Label,
                       typename = typename std::enable_if<traits::is_convertible_label<L>::value>::type>
-            struct svm_problem generate() {
-                ptrs.clear();
-                for (dataset & ds : orig_data)
-                    ptrs.push_back(ds.ptr());
+            auto generate() {
                 raw_labels.clear();
                 for (Label const& l : labels)
                     raw_labels.push_back(l);
+                return generate(orig_data);
+            }
+
+            template <class OtherContainer, class OtherLabel, class OtherStorage>
+            friend class basic_problem;
+        private:
+            // dense samples have to fill the rows of the matrix exactly
+            void check_dim (dense_dataset const& ds) const {
+                if (ds.size() != this->dim())
+                    throw std::invalid_argument("sample does not match "
+                                                "dimension of problem");
+            }
+
+            template <class Container>
+            void check_dim (Container const&) const {}
+
+            struct svm_problem generate (csr_storage & data) {
+                ptrs.clear();
+                ptrs.reserve(data.size());
+                for (size_t i = 0; i < data.size(); ++i)
+                    ptrs.push_back(data.row(i));
                 struct svm_problem p;
                 p.x = ptrs.data();
                 p.y = raw_labels.data();
@@ -68,11 +134,31 @@ namespace svm {
                 return p;
             }
 
-            template <class OtherContainer, class OtherLabel>
-            friend class basic_problem;
-        private:
-            using basic_problem<dataset, Label>::orig_data;
-            using basic_problem<dataset, Label>::labels;
+            // fixed_datasets are stored back to back, i.e. as a row-major
+            // matrix which libsvm trains on without conversion to nodes
+            template <size_t N>
+            struct svm_dense_problem generate (std::vector<fixed_dataset<N>> const& data) {
+                static_assert(sizeof(fixed_dataset<N>) == N * sizeof(double),
+                              "fixed_dataset is not contiguous");
+                struct svm_dense_problem p;
+                p.x = data.empty() ? nullptr : data.front().data();
+                p.y = raw_labels.data();
+                p.l = raw_labels.size();
+                p.dim = N;
+                return p;
+            }
+
+            struct svm_dense_problem generate (dense_storage const& data) {
+                struct svm_dense_problem p;
+                p.x = data.data();
+                p.y = raw_labels.data();
+                p.l = raw_labels.size();
+                p.dim = this->dim();
+                return p;
+            }
+
+            using base_type::orig_data;
+            using base_type::labels;
             std::vector<struct svm_node *> ptrs;
             std::vector<double> raw_labels;
         };
@@ -85,7 +85,29 @@ namespace svm {
                 return dataset(v, 0, false);
             }
 
-            template <class OtherContainer, class OtherLabel>
+            // keeps only the samples with the given (zero-based) indices, in
+            // that order, and releases the kernel matrix
+            void retain(std::vector<size_t> const& indices) {
+                std::vector<Container> retained_data;
+                std::vector<Label> retained_labels;
+                retained_data.reserve(indices.size());
+                retained_labels.reserve(indices.size());
+                for (size_t i : indices) {
+                    retained_data.push_back(std::move(orig_data[i]));
+                    retained_labels.push_back(labels[i]);
+                }
+                orig_data = std::move(retained_data);
+                labels = std::move(retained_labels);
+                std::vector<dataset>().swap(kernel_data);
+                std::vector<struct svm_node *>().swap(ptrs);
+            }
+
+            // kernel of xi with the j-th training sample (zero-based)
+            double kernel_value(Container const& xi, size_t j) const {
+                return kernel(xi, orig_data[j]);
+            }
+
+            template <class OtherContainer, class OtherLabel, class OtherStorage>
             friend class basic_problem;
 
             template <class OtherKernel, class OtherContainer, class OtherLabel>
@@ -0,0 +1,92 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <svm/detail/dense_kernels.hpp>
+#include <svm/detail/dense_matrix.hpp>
+#include <svm/libsvm/svm.h>
+
+
+namespace svm {
+    namespace detail {
+
+        // decision functions of the form f(x) = c + b.x + x^T A x, one for
+        // each classifier, as arise from the polynomial kernel of degree 2
+        class quadratic_forms {
+        public:
+            quadratic_forms () = default;
+
+            quadratic_forms (size_t nr_forms, size_t dim)
+                : A(nr_forms * dim, dim)
+                , b(nr_forms, dim)
+                , c(nr_forms, 0.)
+            {
+            }
+
+            bool empty () const {
+                return b.empty();
+            }
+
+            size_t cols () const {
+                return b.cols();
+            }
+
+            size_t stride () const {
+                return b.stride();
+            }
+
+            // adds the contribution yalpha * K(x, .) of the support vector x
+            // to the p-th form, where K(x, y) = (gamma x.y + coef0)^2
+            void add (size_t p, double yalpha, struct svm_node const * x,
+                      double gamma, double coef0)
+            {
+                size_t dim = b.cols();
+                c[p] += yalpha * coef0 * coef0;
+                double * bp = b.row(p);
+                for (auto xi = x; xi->index != -1; ++xi) {
+                    bp[xi->index - 1] += 2 * yalpha * gamma * coef0 * xi->value;
+                    double * Ai = A.row(p * dim + xi->index - 1);
+                    for (auto xj = x; xj->index != -1; ++xj)
+                        Ai[xj->index - 1] += yalpha * gamma * gamma
+                            * xi->value * xj->value;
+                }
+            }
+
+            void subtract (size_t p, double rho) {
+                c[p] -= rho;
+            }
+
+            double operator() (size_t p, double const * x) const {
+                size_t dim = b.cols();
+                double sum = c[p] + dot(b.row(p), x, dim);
+                for (size_t i = 0; i < dim; ++i)
+                    sum += x[i] * dot(A.row(p * dim + i), x, dim);
+                return sum;
+            }
+
+        private:
+            dense_matrix A, b;
+            std::vector<double> c;
+        };
+
+    }
+}
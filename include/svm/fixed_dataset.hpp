@@ -0,0 +1,61 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+
+
+namespace svm {
+
+    // dense sample of compile-time dimension N, used as the input container
+    // of fixed-dimension problems and models; missing trailing components
+    // are zero
+    template <size_t N>
+    class fixed_dataset : public std::array<double, N> {
+    public:
+        fixed_dataset () : std::array<double, N> {} {}
+
+        fixed_dataset (std::array<double, N> const& a)
+            : std::array<double, N>(a) {}
+
+        template <typename InputIterator>
+        fixed_dataset (InputIterator begin, InputIterator end)
+            : std::array<double, N> {}
+        {
+            for (size_t i = 0; begin != end; ++i, ++begin) {
+                if (i == N)
+                    throw std::invalid_argument("sample exceeds fixed dimension");
+                (*this)[i] = *begin;
+            }
+        }
+
+        template <typename Container>
+        fixed_dataset (Container const& c)
+            : fixed_dataset(std::begin(c), std::end(c)) {}
+
+        fixed_dataset (std::initializer_list<double> il)
+            : fixed_dataset(il.begin(), il.end()) {}
+    };
+
+}
@@ -19,9 +19,11 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include <utility>
 
+#include <svm/dataset.hpp>
 #include <svm/model.hpp>
 #include <svm/problem.hpp>
 #include <svm/parameters.hpp>
@@ -41,9 +43,9 @@ namespace svm {
 
     }
 
-    template <class Label>
-    class problem<kernel::linear, Label> : public detail::patch_through_problem<Label> {
-        using detail::patch_through_problem<Label>::patch_through_problem;
+    template <class Label, size_t Dim>
+    class problem<kernel::linear, Label, Dim> : public detail::patch_through_problem<Label, Dim> {
+        using detail::patch_through_problem<Label, Dim>::patch_through_problem;
     };
 
     template <>
@@ -67,13 +69,8 @@ namespace svm {
 
         double coefficient(size_t i) const {
             double c = 0;
-            for (auto p : classifier) {
-                double yalpha = p.first;
-                auto const& x = p.second;
-                auto itX = x.begin();
-                std::advance(itX, i);
-                c += yalpha * *itX;
-            }
+            for (auto p : classifier)
+                c += p.first * component(p.second, i);
             return c;
         }
 
@@ -82,6 +79,23 @@ namespace svm {
         }
 
     private:
+        static double component(data_view x, size_t i) {
+            for (auto nz : x.nonzeros()) {
+                if (nz.first == i)
+                    return nz.second;
+                if (nz.first > i)
+                    break;
+            }
+            return 0.;
+        }
+
+        template <class Container>
+        static double component(Container const& x, size_t i) {
+            auto it = x.begin();
+            std::advance(it, i);
+            return *it;
+        }
+
         Classifier classifier;
     };
 
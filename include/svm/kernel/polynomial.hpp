@@ -48,9 +48,9 @@ namespace svm {
 
     }
 
-    template <size_t D, class Label>
-    class problem<kernel::polynomial<D>, Label> : public detail::patch_through_problem<Label> {
-        using detail::patch_through_problem<Label>::patch_through_problem;
+    template <size_t D, class Label, size_t Dim>
+    class problem<kernel::polynomial<D>, Label, Dim> : public detail::patch_through_problem<Label, Dim> {
+        using detail::patch_through_problem<Label, Dim>::patch_through_problem;
     };
 
     template <size_t D>
@@ -96,12 +96,16 @@ namespace svm {
             for (auto p : classifier) {
                 std::tie(yalpha, x) = std::move(p);
                 double prod = 1.;
-                size_t j = 0;
-                auto itX = x.begin();
+                auto nonzeros = x.nonzeros();
+                auto nz = nonzeros.begin();
                 for (size_t i : ind) {
-                    std::advance(itX, i - j);
-                    j = i;
-                    prod *= *itX;
+                    while (nz != nonzeros.end() && (*nz).first < i)
+                        ++nz;
+                    if (nz == nonzeros.end() || (*nz).first != i) {
+                        prod = 0.;
+                        break;
+                    }
+                    prod *= (*nz).second;
                 }
                 sum += yalpha * prod;
             }
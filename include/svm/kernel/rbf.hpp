@@ -39,9 +39,9 @@ namespace svm {
 
     }
 
-    template <class Label>
-    class problem<kernel::rbf, Label> : public detail::patch_through_problem<Label> {
-        using detail::patch_through_problem<Label>::patch_through_problem;
+    template <class Label, size_t Dim>
+    class problem<kernel::rbf, Label, Dim> : public detail::patch_through_problem<Label, Dim> {
+        using detail::patch_through_problem<Label, Dim>::patch_through_problem;
     };
 
     template <>
@@ -53,6 +53,14 @@ struct svm_problem
 	struct svm_node **x;
 };
 
+struct svm_dense_problem
+{
+	int l;
+	int dim;
+	double *y;
+	const double *x;	/* row-major l x dim matrix, column k holds index k+1 */
+};
+
 enum { C_SVC, NU_SVC, ONE_CLASS, EPSILON_SVR, NU_SVR };	/* svm_type */
 enum { LINEAR, POLY, RBF, SIGMOID, PRECOMPUTED }; /* kernel_type */
 
@@ -102,7 +110,18 @@ struct svm_model
 				/* 0 if svm_model is created by svm_train */
 };
 
+//
+// svm_workspace
+//
+struct svm_workspace
+{
+	double *kvalue;		/* kernel values of test sample and SVs (kvalue[l]) */
+	int *start;		/* offsets of each class in SV (start[k]) */
+	int *vote;		/* votes for each class (vote[k]) */
+};
+
 struct svm_model *svm_train(const struct svm_problem *prob, const struct svm_parameter *param);
+struct svm_model *svm_train_dense(const struct svm_dense_problem *prob, const struct svm_parameter *param);
 void svm_cross_validation(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, double *target);
 
 int svm_save_model(const char *model_file_name, const struct svm_model *model);
@@ -116,6 +135,13 @@ int svm_get_nr_sv(const struct svm_model *model);
 double svm_get_svr_probability(const struct svm_model *model);
 
 double svm_predict_values(const struct svm_model *model, const struct svm_node *x, double* dec_values);
+void svm_kernel_values(const struct svm_model *model, const struct svm_node *x, int begin, int end, double *kvalue);
+double svm_predict_values_workspace(const struct svm_model *model, const struct svm_node *x, double* dec_values, struct svm_workspace *ws);
+/* dense x against the model's SVs, which are always stored as svm_node arrays */
+double svm_predict_values_dense(const struct svm_model *model, const double *x, int dim, double* dec_values);
+void svm_kernel_values_dense(const struct svm_model *model, const double *x, int dim, int begin, int end, double *kvalue);
+double svm_predict_kernel_values(const struct svm_model *model, const double *kvalue, double* dec_values, struct svm_workspace *ws);
+double svm_predict_decision_values(const struct svm_model *model, const double *dec_values, struct svm_workspace *ws);
 double svm_predict(const struct svm_model *model, const struct svm_node *x);
 double svm_predict_probability(const struct svm_model *model, const struct svm_node *x, double* prob_estimates);
 
@@ -124,9 +150,15 @@ void svm_free_and_destroy_model(struct svm_model **model_ptr_ptr);
 void svm_destroy_param(struct svm_parameter *param);
 
 const char *svm_check_parameter(const struct svm_problem *prob, const struct svm_parameter *param);
+const char *svm_check_parameter_dense(const struct svm_dense_problem *prob, const struct svm_parameter *param);
 int svm_check_probability_model(const struct svm_model *model);
 
 void svm_set_print_string_function(void (*print_func)(const char *));
+/* called after each one-vs-one subproblem of svm_train with the labels of its */
+/* two classes, its number of training vectors and its start and end time in */
+/* seconds since the subproblems were dispatched; NULL disables the report */
+/* (the models fitted internally for probability estimates are not reported) */
+void svm_set_train_report_function(void (*report_func)(int label_i, int label_j, int l, double start, double end));
 
 #ifdef __cplusplus
 }
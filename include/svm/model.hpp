@@ -21,15 +21,27 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <new>
 #include <numeric>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <svm/dataset.hpp>
+#include <svm/fixed_dataset.hpp>
 #include <svm/problem.hpp>
 #include <svm/parameters.hpp>
+#include <svm/detail/aligned_allocator.hpp>
 #include <svm/detail/container_factory.hpp>
+#include <svm/detail/dense_kernels.hpp>
+#include <svm/detail/dense_matrix.hpp>
+#include <svm/detail/dense_sv_block.hpp>
+#include <svm/detail/gemm.hpp>
+#include <svm/detail/quadratic_forms.hpp>
 #include <svm/libsvm/svm.h>
 #include <svm/serialization/serializer.hpp>
 #include <svm/traits/label_traits.hpp>
@@ -37,18 +49,20 @@
 
 namespace svm {
 
-    template <class Kernel, class Label = double>
+    template <class Kernel, class Label = double, size_t Dim = DYNAMIC>
     class model {
     private:
         static const size_t NRL = traits::label_traits<Label>::nr_labels;
         static const size_t NRC = NRL * (NRL - 1) / 2;
     public:
         typedef Kernel kernel_type;
-        typedef problem<Kernel, Label> problem_t;
+        typedef problem<Kernel, Label, Dim> problem_t;
         typedef parameters<Kernel> parameters_t;
         typedef typename problem_t::input_container_type input_container_type;
         typedef Label label_type;
 
+        class predict_workspace;
+
         struct classifier_type {
 
             using kernel_type = model::kernel_type;
@@ -194,25 +208,47 @@ namespace svm {
                 };
             }
 
-            template <typename...,
-                      typename L = Label,
-                      typename = std::enable_if_t<traits::is_binary_label<L>::value>>
-            std::pair<Label, double> operator() (input_container_type const& xj) {
-                auto p = parent.raw_eval(xj);
-                double & dec = detail::container_factory<decltype(p.second)>::ptr(p.second)[k_comb];
-                dec *= swapped;
-                return p;
+            // the label predicted by the whole model along with the value of
+            // this classifier's decision function
+            std::pair<Label, double> operator() (input_container_type const& xj) const {
+                predict_workspace ws(parent);
+                return (*this)(xj, ws);
+            }
+
+            std::pair<Label, double> operator() (input_container_type const& xj,
+                                                 predict_workspace & ws) const
+            {
+                Label l = parent.raw_eval(xj, ws);
+                return {l, swapped * ws.raw_decision[k_comb]};
             }
 
-            template <typename...,
-                      typename L = Label,
-                      typename = std::enable_if_t<!traits::is_binary_label<L>::value>,
-                      bool dummy = true>
-            std::pair<Label, double> operator() (input_container_type const& xj) {
-                auto p = parent.raw_eval(xj);
-                double & dec = detail::container_factory<decltype(p.second)>::ptr(p.second)[k_comb];
-                dec *= swapped;
-                return {p.first, dec};
+            // the winner of this classifier's own decision along with its
+            // value; only evaluates the kernel for the support vectors of the
+            // two classes involved
+            std::pair<Label, double> pairwise (input_container_type const& xj) const {
+                predict_workspace ws(parent);
+                return pairwise(xj, ws);
+            }
+
+            std::pair<Label, double> pairwise (input_container_type const& xj,
+                                               predict_workspace & ws) const
+            {
+                parent.fit_workspace(ws);
+                double dec;
+                if (parent.collapsed_decision(xj, ws, k_comb, dec, is_precomputed_tag {}))
+                    return result(dec);
+                parent.kernel_values(xj, ws, {{k1_offset, k1_offset + parent.m->nSV[k1]},
+                                              {k2_offset, k2_offset + parent.m->nSV[k2]}});
+                return result(kernel_decision(ws));
+            }
+
+            // pairwise decision using the kernel values previously computed by
+            // model::kernel_values, which may be shared among classifiers
+            std::pair<Label, double> pairwise (predict_workspace const& ws) const {
+                if (ws.kvalue_model != parent.m)
+                    throw std::logic_error("workspace holds no kernel values of "
+                                           "this model; call model::kernel_values first");
+                return result(kernel_decision(ws));
             }
 
             double rho () const {
@@ -233,6 +269,24 @@ namespace svm {
             }
 
         private:
+            // decision function value from the kernel values of the two
+            // classes' support vectors in ws
+            double kernel_decision (predict_workspace const& ws) const {
+                double const * coef1 = parent.m->sv_coef[k2-1];
+                double const * coef2 = parent.m->sv_coef[k1];
+                double const * kvalue = ws.kvalue.data();
+                double sum = 0;
+                for (size_t i = k1_offset; i < k1_offset + parent.m->nSV[k1]; ++i)
+                    sum += coef1[i] * kvalue[i];
+                for (size_t i = k2_offset; i < k2_offset + parent.m->nSV[k2]; ++i)
+                    sum += coef2[i] * kvalue[i];
+                return sum - parent.m->rho[k_comb];
+            }
+
+            std::pair<Label, double> result (double dec) const {
+                return {Label(parent.m->label[dec > 0 ? k1 : k2]), swapped * dec};
+            }
+
             model const& parent;
             size_t k1, k2;
             size_t k1_offset, k2_offset, k_comb;
@@ -268,19 +322,55 @@ namespace svm {
                                                     std::vector<classifier_type>,
                                                     std::array<classifier_type, NRC>>;
 
-        model () : prob(0), m(nullptr) {}
+        class predict_workspace {
+        public:
+            predict_workspace () = default;
+
+            predict_workspace (model const& parent)
+                : kvalue(parent.m->l)
+                , start(parent.nr_labels())
+                , vote(parent.nr_labels())
+                , raw_decision(parent.nr_classifiers())
+                , decision(detail::container_factory<decision_type>::create(parent.nr_classifiers()))
+                , dense_x(parent.dense_stride())
+            {
+            }
+
+            struct svm_workspace * ptr () {
+                ws.kvalue = kvalue.data();
+                ws.start = start.data();
+                ws.vote = vote.data();
+                return &ws;
+            }
+
+            friend class model;
+        private:
+            std::vector<double> kvalue;
+            // the model whose kernel values with the last sample kvalue holds
+            // in full, if any
+            struct svm_model const * kvalue_model = nullptr;
+            std::vector<int> start, vote;
+            std::vector<double> raw_decision;
+            decision_type decision;
+            detail::aligned_vector<double> dense_x;
+            detail::dense_matrix batch_x, batch_k, batch_decision;
+            std::vector<double> batch_xx;
+            struct svm_workspace ws {};
+        };
+
+        model () : prob(is_fixed_dim(Dim) ? Dim : 0), m(nullptr) {}
 
         model (problem_t && problem, parameters_t const& parameters)
             : prob(std::move(problem)),
               params_(parameters)
         {
-            struct svm_problem svm_prob = prob.generate();
-            const char * err = svm_check_parameter(&svm_prob, params_.svm_params_ptr());
+            auto svm_prob = prob.generate();
+            const char * err = check_parameter(svm_prob, params_.svm_params_ptr());
             if (err) {
                 std::string err_str(err);
                 throw std::runtime_error(err_str);
             }
-            m = svm_train(&svm_prob, params_.svm_params_ptr());
+            m = train(svm_prob, params_.svm_params_ptr());
             if (!traits::is_dynamic_label<Label>::value
                 && size_t(m->nr_class) != traits::label_traits<Label>::nr_labels)
             {
@@ -289,7 +379,8 @@ namespace svm {
             if (std::any_of(m->rho, m->rho + nr_classifiers(),
                             [] (double r) { return std::isnan(r); }))
                 throw std::runtime_error("SVM returned NaN. Specified nu is infeasible.");
-            init_perm();
+            compact(is_precomputed_tag {});
+            init();
         }
 
         model (model const&) = delete;
@@ -298,7 +389,11 @@ namespace svm {
         model (model && other)
             : prob(std::move(other.prob)),
               params_(other.params_),
-              m(other.m)
+              m(other.m),
+              weights(std::move(other.weights)),
+              quad(std::move(other.quad)),
+              sv_block(std::move(other.sv_block)),
+              sv_coefs(std::move(other.sv_coefs))
         {
             other.m = nullptr;
             init_perm();
@@ -311,6 +406,10 @@ namespace svm {
                 svm_free_and_destroy_model(&m);
             m = other.m;
             other.m = nullptr;
+            weights = std::move(other.weights);
+            quad = std::move(other.quad);
+            sv_block = std::move(other.sv_block);
+            sv_coefs = std::move(other.sv_coefs);
             init_perm();
             return *this;
         }
@@ -368,42 +467,184 @@ namespace svm {
             return classifier_type {*this, perm_inv[0], perm_inv[1]};
         }
 
-        template <typename Problem = problem_t,
+        template <class Sample>
+        std::pair<Label, decision_type> raw_eval(Sample const& xj) const {
+            predict_workspace ws(*this);
+            Label l = raw_eval(xj, ws);
+            return {l, detail::container_factory<decision_type>::copy(ws.raw_decision)};
+        }
+
+        template <class Sample, typename Problem = problem_t,
                   typename = std::enable_if_t<!Problem::is_precomputed>>
-        std::pair<Label, decision_type> raw_eval(input_container_type const& xj) const {
-            std::pair<Label, decision_type> ret {
-                Label{},
-                detail::container_factory<decision_type>::create(nr_classifiers())
-            };
-            ret.first = Label{svm_predict_values(m, xj.ptr(),
-                                                 detail::container_factory<decision_type>::ptr(ret.second))};
-            return ret;
+        Label raw_eval(Sample const& xj, predict_workspace & ws) const {
+            fit_workspace(ws);
+            if (!weights.empty()) {
+                densify_into(xj, ws, weights.cols());
+                for (size_t p = 0; p < weights.rows(); ++p)
+                    ws.raw_decision[p] = dense_dot(weights.row(p), ws.dense_x.data(),
+                                                   weights.cols()) - m->rho[p];
+                return vote(ws.raw_decision.data(), ws);
+            }
+            if (!quad.empty()) {
+                densify_into(xj, ws, quad.cols());
+                for (size_t p = 0; p < nr_classifiers(); ++p)
+                    ws.raw_decision[p] = quad(p, ws.dense_x.data());
+                return vote(ws.raw_decision.data(), ws);
+            }
+            kernel_values(xj, ws);
+            return vote_kernel_values(ws);
         }
 
-        template <typename Problem = problem_t,
+        template <class Sample, typename Problem = problem_t,
                   typename = std::enable_if_t<Problem::is_precomputed>,
                   bool dummy = false>
-        std::pair<Label, decision_type> raw_eval(input_container_type const& xj) const {
-            dataset kernelized = prob.kernelize(xj);
-            std::pair<Label, decision_type> ret {
-                Label{},
-                detail::container_factory<decision_type>::create(nr_classifiers())
-            };
-            ret.first = Label{svm_predict_values(m, kernelized.ptr(),
-                                                 detail::container_factory<decision_type>::ptr(ret.second))};
-            return ret;
+        Label raw_eval(Sample const& xj, predict_workspace & ws) const {
+            fit_workspace(ws);
+            kernel_values(xj, ws);
+            return vote_kernel_values(ws);
+        }
+
+        // computes the kernel values of xj with all support vectors into ws
+        // for use by classifier_type::pairwise(predict_workspace const&)
+        template <class Sample>
+        void kernel_values (Sample const& xj, predict_workspace & ws) const
+        {
+            fit_workspace(ws);
+            kernel_values(xj, ws, {{0, size_t(m->l)}});
+            ws.kvalue_model = m;
         }
 
         std::pair<Label, decision_type> operator() (input_container_type const& xj) const {
-            auto p = raw_eval(xj);
-            permute(p.second);
-            return p;
+            predict_workspace ws(*this);
+            return (*this)(xj, ws);
+        }
+
+        std::pair<Label, decision_type const&> operator() (input_container_type const& xj,
+                                                          predict_workspace & ws) const
+        {
+            Label l = raw_eval(xj, ws);
+            permute_into(ws.raw_decision.data(), ws.decision);
+            return {l, ws.decision};
+        }
+
+        // built-in kernels also evaluate samples borrowed from the caller,
+        // either as svm_node arrays or as dense arrays, without copying them
+        template <typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        std::pair<Label, decision_type> operator() (data_view xj) const {
+            predict_workspace ws(*this);
+            return (*this)(xj, ws);
+        }
+
+        template <typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        std::pair<Label, decision_type const&> operator() (data_view xj,
+                                                          predict_workspace & ws) const
+        {
+            Label l = raw_eval(xj, ws);
+            permute_into(ws.raw_decision.data(), ws.decision);
+            return {l, ws.decision};
+        }
+
+        template <typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        std::pair<Label, decision_type> operator() (dense_view xj) const {
+            predict_workspace ws(*this);
+            return (*this)(xj, ws);
+        }
+
+        template <typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        std::pair<Label, decision_type const&> operator() (dense_view xj,
+                                                          predict_workspace & ws) const
+        {
+            Label l = raw_eval(xj, ws);
+            permute_into(ws.raw_decision.data(), ws.decision);
+            return {l, ws.decision};
+        }
+
+        predict_workspace workspace () const {
+            return predict_workspace(*this);
+        }
+
+        template <typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        void compile () {
+            sv_block = detail::dense_sv_block(m->SV, m->l, dim());
+            sv_coefs = detail::dense_matrix(nr_classifiers(), m->l);
+            for_each_coef([&] (size_t p, double yalpha, size_t k) {
+                sv_coefs.row(p)[k] = yalpha;
+            });
+        }
+
+        bool compiled () const {
+            return !sv_block.empty() || !quad.empty();
+        }
+
+        // for the polynomial kernel of degree 2, expand the decision functions
+        // into their quadratic forms (cf. tensor_introspector) which are
+        // cheaper to evaluate than the support vector expansion as long as
+        // the dimension is small compared to the number of support vectors
+        template <typename K = Kernel,
+                  typename = std::enable_if_t<K::Degree == 2>>
+        void compile_quadratic_form () {
+            quad = detail::quadratic_forms(nr_classifiers(),
+                                           detail::dense_dim(m->SV, m->l, dim()));
+            for_each_coef([&] (size_t p, double yalpha, size_t k) {
+                quad.add(p, yalpha, m->SV[k], m->param.gamma, m->param.coef0);
+            });
+            for (size_t p = 0; p < nr_classifiers(); ++p)
+                quad.subtract(p, m->rho[p]);
+        }
+
+        template <typename RandomAccessIterator,
+                  typename LabelIterator,
+                  typename DecisionIterator>
+        void predict_batch (RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            LabelIterator labels_out,
+                            DecisionIterator decisions_out) const
+        {
+            predict_batch_impl(std::distance(first, last),
+                               [&] (std::ptrdiff_t i) -> decltype(auto) {
+                                   return first[i];
+                               },
+                               labels_out, decisions_out);
+        }
+
+        template <typename LabelIterator, typename DecisionIterator>
+        void predict_batch (problem_t const& batch,
+                            LabelIterator labels_out,
+                            DecisionIterator decisions_out) const
+        {
+            predict_batch_impl(batch.size(),
+                               [&] (std::ptrdiff_t i) -> decltype(auto) {
+                                   return batch.view(i).first;
+                               },
+                               labels_out, decisions_out);
+        }
+
+        // serial counterpart of predict_batch, running on the calling thread
+        template <typename RandomAccessIterator,
+                  typename LabelIterator,
+                  typename DecisionIterator>
+        void predict_batch (RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            LabelIterator labels_out,
+                            DecisionIterator decisions_out,
+                            predict_workspace & ws) const
+        {
+            fit_workspace(ws);
+            predict_block([&] (std::ptrdiff_t i) -> decltype(auto) {
+                              return first[i];
+                          },
+                          0, std::distance(first, last),
+                          labels_out, decisions_out, ws, is_precomputed_tag {});
         }
 
         decision_type rho() const {
-            auto r = detail::container_factory<decision_type>::copy(
-                m->rho, m->rho + nr_classifiers());
-            permute(r);
+            auto r = detail::container_factory<decision_type>::create(nr_classifiers());
+            permute_into(m->rho, r);
             return r;
         }
 
@@ -428,6 +669,357 @@ namespace svm {
         friend struct serialization::model_serializer;
 
     private:
+        void init () {
+            init_perm();
+            init_weights();
+            quad = detail::quadratic_forms {};
+            sv_block = detail::dense_sv_block {};
+            sv_coefs = detail::dense_matrix {};
+            init_dense(is_dense_tag {});
+        }
+
+        using is_dense_tag = std::integral_constant<bool, Dim != DYNAMIC>;
+
+        // fixed-dimension and dense models evaluate densely only, against a
+        // dense copy of the support vectors
+        void init_dense (std::true_type) {
+            if (detail::dense_dim(m->SV, m->l, dim()) != dim())
+                throw std::runtime_error("support vectors exceed dimension of model");
+            if (weights.empty())
+                compile();
+        }
+
+        void init_dense (std::false_type) {}
+
+        using is_precomputed_tag = std::integral_constant<bool, problem_t::is_precomputed>;
+
+        // copies the support vectors into a single block owned by the model
+        // and releases the training samples which the SVs used to point into
+        void compact (std::false_type) {
+            if (m->l > 0 && !m->free_sv) {
+                size_t nr_nodes = 0;
+                for (int i = 0; i < m->l; ++i) {
+                    struct svm_node const * node = m->SV[i];
+                    while (node->index != -1)
+                        ++node;
+                    nr_nodes += node - m->SV[i] + 1;
+                }
+                struct svm_node * dest = allocate_nodes(nr_nodes);
+                for (int i = 0; i < m->l; ++i) {
+                    struct svm_node const * node = m->SV[i];
+                    m->SV[i] = dest;
+                    while (node->index != -1)
+                        *dest++ = *node++;
+                    *dest++ = *node;
+                }
+                m->free_sv = 1;
+            }
+            prob = problem_t(prob.dim());
+        }
+
+        // keeps only the samples which became support vectors, renumbered in
+        // SV order, and drops the kernel matrix computed for training
+        void compact (std::true_type) {
+            std::vector<size_t> sv_samples(m->l);
+            if (m->l > 0) {
+                struct svm_node * block = allocate_nodes(2 * m->l);
+                for (int i = 0; i < m->l; ++i) {
+                    sv_samples[i] = size_t(m->SV[i][0].value) - 1;
+                    block[2 * i] = {0, double(i + 1)};
+                    block[2 * i + 1] = {-1, 0.};
+                    m->SV[i] = block + 2 * i;
+                }
+                m->free_sv = 1;
+            }
+            prob.retain(sv_samples);
+        }
+
+        static const char * check_parameter (struct svm_problem const& p,
+                                             struct svm_parameter const* params)
+        {
+            return svm_check_parameter(&p, params);
+        }
+
+        static const char * check_parameter (struct svm_dense_problem const& p,
+                                             struct svm_parameter const* params)
+        {
+            return svm_check_parameter_dense(&p, params);
+        }
+
+        static struct svm_model * train (struct svm_problem const& p,
+                                         struct svm_parameter const* params)
+        {
+            return svm_train(&p, params);
+        }
+
+        static struct svm_model * train (struct svm_dense_problem const& p,
+                                         struct svm_parameter const* params)
+        {
+            return svm_train_dense(&p, params);
+        }
+
+        // storage for SVs to be released by svm_free_model_content
+        static struct svm_node * allocate_nodes (size_t n) {
+            auto block = static_cast<struct svm_node *>(
+                std::malloc(n * sizeof(struct svm_node)));
+            if (!block)
+                throw std::bad_alloc();
+            return block;
+        }
+
+        static const std::ptrdiff_t batch_block = 64;
+
+        template <typename Sample, typename LabelIterator, typename DecisionIterator>
+        void predict_batch_impl (std::ptrdiff_t n, Sample sample,
+                                 LabelIterator labels_out,
+                                 DecisionIterator decisions_out) const
+        {
+#pragma omp parallel
+            {
+                predict_workspace ws(*this);
+#pragma omp for schedule(dynamic)
+                for (std::ptrdiff_t b = 0; b < n; b += batch_block)
+                    predict_block(sample, b, std::min(b + batch_block, n),
+                                  labels_out, decisions_out, ws,
+                                  is_precomputed_tag {});
+            }
+        }
+
+        template <typename Sample, typename LabelIterator, typename DecisionIterator>
+        void predict_block (Sample sample, std::ptrdiff_t begin, std::ptrdiff_t end,
+                            LabelIterator labels_out,
+                            DecisionIterator decisions_out,
+                            predict_workspace & ws,
+                            std::false_type) const
+        {
+            if (sv_block.empty() || !weights.empty() || !quad.empty()) {
+                // evaluate the samples one by one
+                predict_block(sample, begin, end, labels_out, decisions_out, ws,
+                              std::true_type {});
+                return;
+            }
+
+            // compiled model: evaluate the kernel for blocks of samples by
+            // matrix multiplication with the support vectors, then contract
+            // with the coefficients of the decision functions likewise
+            if (ws.batch_x.cols() != sv_block.cols()
+                || ws.batch_k.cols() != sv_block.rows())
+            {
+                ws.batch_x = detail::dense_matrix(batch_block, sv_block.cols());
+                ws.batch_k = detail::dense_matrix(batch_block, sv_block.rows());
+                ws.batch_decision = detail::dense_matrix(batch_block, nr_classifiers());
+                ws.batch_xx.resize(batch_block);
+            }
+            for (std::ptrdiff_t b = begin; b < end; b += batch_block) {
+                size_t nb = std::min(batch_block, end - b);
+                for (size_t i = 0; i < nb; ++i)
+                    ws.batch_xx[i] = densify(sample(b + i),
+                                             ws.batch_x.row(i),
+                                             ws.batch_x.cols());
+                detail::gemm_nt(ws.batch_x, sv_block.matrix(), ws.batch_k, nb);
+                for (size_t i = 0; i < nb; ++i)
+                    sv_block.apply_kernel(m->param, ws.batch_k.row(i), ws.batch_xx[i]);
+                detail::gemm_nt(ws.batch_k, sv_coefs, ws.batch_decision, nb);
+                for (size_t i = 0; i < nb; ++i) {
+                    double * dec = ws.batch_decision.row(i);
+                    for (size_t p = 0; p < nr_classifiers(); ++p)
+                        dec[p] -= m->rho[p];
+                    labels_out[b + i] = vote(dec, ws);
+                    permute_into(dec, ws.decision);
+                    decisions_out[b + i] = ws.decision;
+                }
+            }
+        }
+
+        template <typename Sample, typename LabelIterator, typename DecisionIterator>
+        void predict_block (Sample sample, std::ptrdiff_t begin, std::ptrdiff_t end,
+                            LabelIterator labels_out,
+                            DecisionIterator decisions_out,
+                            predict_workspace & ws,
+                            std::true_type) const
+        {
+            for (std::ptrdiff_t i = begin; i < end; ++i) {
+                auto p = (*this)(sample(i), ws);
+                labels_out[i] = p.first;
+                decisions_out[i] = p.second;
+            }
+        }
+
+        // workspaces which are default-constructed or were obtained from a
+        // different model are reinitialized before use; any evaluation
+        // invalidates the kernel values until kernel_values fills them anew
+        void fit_workspace (predict_workspace & ws) const {
+            if (ws.kvalue.size() != size_t(m->l)
+                || ws.raw_decision.size() != nr_classifiers())
+            {
+                ws = predict_workspace(*this);
+            }
+            ws.kvalue_model = nullptr;
+        }
+
+        template <class Sample>
+        double densify_into (Sample const& xj,
+                             predict_workspace & ws, size_t cols) const
+        {
+            if (ws.dense_x.size() < dense_stride())
+                ws.dense_x.resize(dense_stride());
+            return densify(xj, ws.dense_x.data(), cols);
+        }
+
+        static double densify (data_view x, double * x_dense, size_t cols) {
+            if (!x.ptr()) {
+                std::fill(x_dense, x_dense + cols, 0.);
+                return 0.;
+            }
+            return detail::densify(x.ptr(), x_dense, cols);
+        }
+
+        static double densify (dense_view x, double * x_dense, size_t cols) {
+            size_t n = std::min(x.size(), cols);
+            std::copy(x.data(), x.data() + n, x_dense);
+            std::fill(x_dense + n, x_dense + cols, 0.);
+            return detail::dot(x.data(), x.data(), x.size());
+        }
+
+        template <size_t N>
+        static double densify (fixed_dataset<N> const& x, double * x_dense, size_t cols) {
+            std::copy(x.begin(), x.end(), x_dense);
+            std::fill(x_dense + N, x_dense + cols, 0.);
+            return detail::dot(x.data(), x.data(), N);
+        }
+
+        // dot product of dense vectors of length n, which is known at compile
+        // time for fixed-dimension models
+        static double dense_dot (double const * x, double const * y, size_t n) {
+            return detail::dot(x, y, is_fixed_dim(Dim) ? Dim : n);
+        }
+
+        // evaluates decision function p directly if the model has been
+        // collapsed into weight vectors or quadratic forms
+        template <class Sample>
+        bool collapsed_decision (Sample const& xj,
+                                 predict_workspace & ws,
+                                 size_t p, double & dec,
+                                 std::false_type) const
+        {
+            if (!weights.empty()) {
+                densify_into(xj, ws, weights.cols());
+                dec = dense_dot(weights.row(p), ws.dense_x.data(), weights.cols())
+                    - m->rho[p];
+                return true;
+            }
+            if (!quad.empty()) {
+                densify_into(xj, ws, quad.cols());
+                dec = quad(p, ws.dense_x.data());
+                return true;
+            }
+            return false;
+        }
+
+        template <class Sample>
+        bool collapsed_decision (Sample const&, predict_workspace &,
+                                 size_t, double &, std::true_type) const
+        {
+            return false;
+        }
+
+        // fills ws.kvalue[begin:end] for each of the given ranges of SVs
+        template <class Sample, typename Problem = problem_t,
+                  typename = std::enable_if_t<!Problem::is_precomputed>>
+        void kernel_values (Sample const& xj, predict_workspace & ws,
+                            std::initializer_list<std::pair<size_t, size_t>> ranges) const
+        {
+            if (!sv_block.empty()) {
+                double xx = densify_into(xj, ws, sv_block.cols());
+                for (auto const& r : ranges) {
+                    for (size_t i = r.first; i < r.second; ++i)
+                        ws.kvalue[i] = dense_dot(ws.dense_x.data(), sv_block.row(i),
+                                                 sv_block.cols());
+                    sv_block.apply_kernel(m->param, ws.kvalue.data(), xx,
+                                          r.first, r.second);
+                }
+            } else {
+                for (auto const& r : ranges)
+                    sparse_kernel_values(xj, ws, r.first, r.second);
+            }
+        }
+
+        void sparse_kernel_values (data_view xj, predict_workspace & ws,
+                                   size_t begin, size_t end) const
+        {
+            static struct svm_node const empty = {-1, 0.};
+            svm_kernel_values(m, xj.ptr() ? xj.ptr() : &empty,
+                              begin, end, ws.kvalue.data());
+        }
+
+        void sparse_kernel_values (dense_view xj, predict_workspace & ws,
+                                   size_t begin, size_t end) const
+        {
+            svm_kernel_values_dense(m, xj.data(), xj.size(), begin, end, ws.kvalue.data());
+        }
+
+        template <size_t N>
+        void sparse_kernel_values (fixed_dataset<N> const& xj, predict_workspace & ws,
+                                   size_t begin, size_t end) const
+        {
+            svm_kernel_values_dense(m, xj.data(), N, begin, end, ws.kvalue.data());
+        }
+
+        template <class Sample, typename Problem = problem_t,
+                  typename = std::enable_if_t<Problem::is_precomputed>,
+                  bool dummy = false>
+        void kernel_values (Sample const& xj, predict_workspace & ws,
+                            std::initializer_list<std::pair<size_t, size_t>> ranges) const
+        {
+            // the support vectors hold the (one-based) training sample index
+            for (auto const& r : ranges)
+                for (size_t i = r.first; i < r.second; ++i)
+                    ws.kvalue[i] = prob.kernel_value(xj, size_t(m->SV[i][0].value) - 1);
+        }
+
+        // calls f(p, yalpha, k) for each support vector k contributing to the
+        // p-th decision function (in libsvm's order) with coefficient yalpha
+        template <typename F>
+        void for_each_coef (F f) const {
+            if (!is_classification()) {
+                // a single decision function expanded in all support vectors
+                for (int k = 0; k < m->l; ++k)
+                    f(0, m->sv_coef[0][k], size_t(k));
+                return;
+            }
+            std::vector<size_t> start(nr_labels() + 1, 0);
+            for (size_t k = 0; k < nr_labels(); ++k)
+                start[k + 1] = start[k] + m->nSV[k];
+            size_t p = 0;
+            for (size_t i = 0; i < nr_labels(); ++i)
+                for (size_t j = i + 1; j < nr_labels(); ++j, ++p) {
+                    for (size_t k = start[i]; k < start[i + 1]; ++k)
+                        f(p, m->sv_coef[j - 1][k], k);
+                    for (size_t k = start[j]; k < start[j + 1]; ++k)
+                        f(p, m->sv_coef[i][k], k);
+                }
+        }
+
+        // for the linear kernel, collapse the support vector expansion of
+        // each decision function into a single weight vector
+        void init_weights () {
+            weights = detail::dense_matrix {};
+            if (m->param.kernel_type != LINEAR
+                || (m->param.svm_type != C_SVC && m->param.svm_type != NU_SVC))
+                return;
+            weights = detail::dense_matrix(nr_classifiers(),
+                                           detail::dense_dim(m->SV, m->l, dim()));
+            for_each_coef([&] (size_t p, double yalpha, size_t k) {
+                double * w = weights.row(p);
+                for (auto x = m->SV[k]; x->index != -1; ++x)
+                    w[x->index - 1] += yalpha * x->value;
+            });
+        }
+
+        size_t dense_stride () const {
+            return std::max({weights.stride(), quad.stride(), sv_block.stride()});
+        }
+
         void init_perm () {
             // prep member vars
             perm_inv = detail::container_factory<perm_t>::create(nr_labels());
@@ -436,10 +1028,12 @@ namespace svm {
 
             // permutation of label indices
             std::iota(perm_inv.begin(), perm_inv.end(), 0);
-            std::sort(perm_inv.begin(), perm_inv.end(),
-                      [this] (size_t k1, size_t k2) {
-                          return label_type(m->label[k1]) < label_type(m->label[k2]);
-                      });
+            // one-class and regression models have no labels
+            if (m->label)
+                std::sort(perm_inv.begin(), perm_inv.end(),
+                          [this] (size_t k1, size_t k2) {
+                              return label_type(m->label[k1]) < label_type(m->label[k2]);
+                          });
 
             // invert
             auto perm = detail::container_factory<perm_t>::create(nr_labels());
@@ -468,28 +1062,92 @@ namespace svm {
                 permc[permc_inv[k]] = k;
                 permc_signs[permc_inv[k]] = signs[k];
             }
+
+            // offsets of the support vectors of each class
+            sv_start = detail::container_factory<sv_start_t>::create(nr_labels() + 1);
+            sv_start[0] = 0;
+            for (size_t k = 0; k < nr_labels(); ++k)
+                sv_start[k+1] = sv_start[k] + (m->nSV ? m->nSV[k] : 0);
         }
 
-        template <typename Container>
-        void permute(Container & arr) const {
-            for (size_t c = 0; c < arr.size(); ++c) {
-                if (permc[c] >= arr.size())
-                    continue;
-                size_t p, h;
-                for (h = c; (p = permc[h]) != c; h = p) {
-                    std::swap(arr[h], arr[p]);
-                    permc[h] += arr.size();
+        using is_static_label_tag =
+            std::integral_constant<bool, !traits::is_dynamic_label<Label>::value>;
+
+        bool is_classification () const {
+            return m->param.svm_type == C_SVC || m->param.svm_type == NU_SVC;
+        }
+
+        // one-vs-one voting on the decision values in libsvm's order
+        Label vote (double const * dec, predict_workspace & ws) const {
+            return vote(dec, ws, is_static_label_tag {});
+        }
+
+        Label vote (double const * dec, predict_workspace & ws, std::false_type) const {
+            return Label{svm_predict_decision_values(m, dec, ws.ptr())};
+        }
+
+        // for static labels, the loops have compile-time bounds and the
+        // votes are tallied without branches on the stack
+        Label vote (double const * dec, predict_workspace & ws, std::true_type) const {
+            if (!is_classification())
+                return vote(dec, ws, std::false_type {});
+            std::array<int, NRL> votes {};
+            size_t p = 0;
+            for (size_t i = 0; i < NRL; ++i) {
+                for (size_t j = i + 1; j < NRL; ++j, ++p) {
+                    int pos = dec[p] > 0;
+                    votes[i] += pos;
+                    votes[j] += 1 - pos;
                 }
-                permc[h] += arr.size();
             }
-            for (size_t c = 0; c < arr.size(); ++c) {
-                arr[c] *= permc_signs[c];
-                permc[c] -= arr.size();
+            size_t winner = 0;
+            for (size_t k = 1; k < NRL; ++k)
+                winner = votes[k] > votes[winner] ? k : winner;
+            return Label{double(m->label[winner])};
+        }
+
+        // computes the decision values from ws.kvalue and votes
+        Label vote_kernel_values (predict_workspace & ws) const {
+            return vote_kernel_values(ws, is_static_label_tag {});
+        }
+
+        Label vote_kernel_values (predict_workspace & ws, std::false_type) const {
+            return Label{svm_predict_kernel_values(m, ws.kvalue.data(),
+                                                   ws.raw_decision.data(),
+                                                   ws.ptr())};
+        }
+
+        Label vote_kernel_values (predict_workspace & ws, std::true_type) const {
+            if (!is_classification())
+                return vote_kernel_values(ws, std::false_type {});
+            double const * kvalue = ws.kvalue.data();
+            double * dec = ws.raw_decision.data();
+            size_t p = 0;
+            for (size_t i = 0; i < NRL; ++i) {
+                for (size_t j = i + 1; j < NRL; ++j, ++p) {
+                    double const * coef1 = m->sv_coef[j-1];
+                    double const * coef2 = m->sv_coef[i];
+                    double sum = 0;
+                    for (size_t k = sv_start[i]; k < sv_start[i+1]; ++k)
+                        sum += coef1[k] * kvalue[k];
+                    for (size_t k = sv_start[j]; k < sv_start[j+1]; ++k)
+                        sum += coef2[k] * kvalue[k];
+                    dec[p] = sum - m->rho[p];
+                }
             }
+            return vote(dec, ws, std::true_type {});
+        }
+
+        // gathers the decision values in libsvm's order from raw into their
+        // final positions in arr, flipping signs where necessary
+        template <typename Container>
+        void permute_into(double const * raw, Container & arr) const {
+            for (size_t c = 0; c < arr.size(); ++c)
+                arr[c] = raw[permc[c]] * permc_signs[c];
         }
 
-        void permute(double & a) const {
-            a *= permc_signs[0];
+        void permute_into(double const * raw, double & a) const {
+            a = *raw * permc_signs[0];
         }
 
         template <size_t... R>
@@ -518,9 +1176,20 @@ namespace svm {
         using permc_signs_t = std::conditional_t<traits::is_dynamic_label<Label>::value,
                                                  std::vector<int>,
                                                  std::array<int, NRC>>;
+        using sv_start_t = std::conditional_t<traits::is_dynamic_label<Label>::value,
+                                              std::vector<size_t>,
+                                              std::array<size_t, NRL + 1>>;
         perm_t perm_inv;
-        mutable permc_t permc;
+        permc_t permc;
         permc_signs_t permc_signs;
+        sv_start_t sv_start;
+        detail::dense_matrix weights;
+        detail::quadratic_forms quad;
+        detail::dense_sv_block sv_block;
+        detail::dense_matrix sv_coefs;
     };
 
+    template <class Kernel, class Label, size_t Dim>
+    const std::ptrdiff_t model<Kernel, Label, Dim>::batch_block;
+
 }
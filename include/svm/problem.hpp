@@ -18,13 +18,20 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <svm/detail/precompute_kernel_problem.hpp>
+#include <svm/traits/label_traits.hpp>
 
 
 namespace svm {
 
-    template <class Kernel, class Label = double>
+    // Dim fixes the dimension of the samples at compile time, or selects
+    // dense samples of a runtime dimension (DENSE); built-in kernels only
+    template <class Kernel, class Label = double, size_t Dim = DYNAMIC>
     class problem : public detail::precompute_kernel_problem<Kernel, typename Kernel::input_container_type, Label> {
+        static_assert(Dim == DYNAMIC,
+                      "precomputed kernels do not support a fixed or dense dimension");
         using detail::precompute_kernel_problem<Kernel, typename Kernel::input_container_type, Label>::precompute_kernel_problem;
     };
 
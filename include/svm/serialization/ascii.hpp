@@ -64,7 +64,7 @@ namespace serialization {
                                             + filename + ".model");
             }
             model_.params_ = typename Model::parameters_t(model_.m->param);
-            model_.init_perm();
+            model_.init();
         }
 
     private:
@@ -80,19 +80,16 @@ namespace serialization {
             : prob_(prob), full(!skip_samples) {}
 
         void save (std::string const& filename) const {
-            using input_t = typename Problem::input_container_type;
             using label_t = typename Problem::label_type;
             using ltraits = typename::svm::traits::label_traits<label_t>;
-            using view_t = typename std::conditional<
-                std::is_same<svm::dataset, input_t>::value,
-                svm::data_view, input_t const&>::type;
+            using view_t = decltype(std::declval<Problem const&>().view(0).first);
 
             std::ofstream os(filename);
             os << prob_.dim() << '\n';
 
             if (full) {
                 for (size_t i = 0; i < prob_.size(); ++i) {
-                    auto p = prob_[i];
+                    auto p = prob_.view(i);
                     view_t xs = p.first;
                     label_t const& l = p.second;
                     for (auto it = ltraits::begin(l); it != ltraits::end(l); ++it) {
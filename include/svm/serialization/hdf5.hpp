@@ -120,15 +120,19 @@ namespace serialization {
                     SVm[i][0] = SV[i]->value;
                 ar["SV"] << SVm;
             } else {
-                boost::multi_array<double,2> SVm(boost::extents[l][model_.prob.dim()]);
+                // nonzeros of SV i are SV_column/SV_value[SV_offset[i]:SV_offset[i+1]]
+                std::vector<int> SV_offset(1, 0), SV_column;
+                std::vector<double> SV_value;
                 for (int i = 0; i < l; ++i) {
-                    svm::data_view v(SV[i]);
-                    auto it = v.begin();
-                    for (int j = 1; it != v.end(); ++j, ++it) {
-                        SVm[i][j-1] = *it;
+                    for (auto nz : svm::data_view(SV[i]).nonzeros()) {
+                        SV_column.push_back(nz.first);
+                        SV_value.push_back(nz.second);
                     }
+                    SV_offset.push_back(SV_column.size());
                 }
-                ar["SV"] << SVm;
+                ar["SV_offset"] << SV_offset;
+                ar["SV_column"] << SV_column;
+                ar["SV_value"] << SV_value;
             }
         }
 
@@ -211,17 +215,10 @@ namespace serialization {
 
             boost::multi_array<double,2> sv_coefm;
             ar["sv_coef"] >> sv_coefm;
-            boost::multi_array<double,2> SVm;
-            ar["SV"] >> SVm;
 
             size_t l = sv_coefm.shape()[0];
             if (sv_coefm.shape()[1] != nr_class-1)
                 throw std::runtime_error("inconsistent data length");
-            if (SVm.shape()[0] != l)
-                throw std::runtime_error("inconsistent data length");
-            size_t expected_size = Model::problem_t::is_precomputed ? 1 : model_.prob.dim();
-            if (SVm.shape()[1] != expected_size)
-                throw std::runtime_error("inconsistent data length");
             model_.m->l = l;
 
             model_.m->sv_coef = (double **)malloc(sizeof(double *) * (nr_class-1));
@@ -233,6 +230,28 @@ namespace serialization {
             }
 
             model_.m->SV = (struct svm_node **)malloc(sizeof(struct svm_node *) * l);
+            if (ar.is_data("SV"))
+                load_dense_SV(ar, l);
+            else
+                load_sparse_SV(ar, l);
+
+            model_.m->free_sv = 1;
+            model_.params_ = typename Model::parameters_t(model_.m->param);
+            model_.init();
+        }
+
+    private:
+        // SVs as a dense l x dim matrix, as written by earlier versions and
+        // still for precomputed kernels
+        void load_dense_SV (alps::hdf5::archive & ar, size_t l) {
+            boost::multi_array<double,2> SVm;
+            ar["SV"] >> SVm;
+            if (SVm.shape()[0] != l)
+                throw std::runtime_error("inconsistent data length");
+            size_t expected_size = Model::problem_t::is_precomputed ? 1 : model_.prob.dim();
+            if (SVm.shape()[1] != expected_size)
+                throw std::runtime_error("inconsistent data length");
+
             struct svm_node * SVmem = (struct svm_node *)malloc(sizeof(struct svm_node) * l * (expected_size + 1));
             size_t start_index = Model::problem_t::is_precomputed ? 0 : 1;
             for (size_t i = 0; i < l; ++i) {
@@ -240,13 +259,43 @@ namespace serialization {
                 model_.m->SV[i] = SVmem + i * (expected_size + 1);
                 std::copy(ds.data().begin(), ds.data().end(), model_.m->SV[i]);
             }
+        }
 
-            model_.m->free_sv = 1;
-            model_.params_ = typename Model::parameters_t(model_.m->param);
-            model_.init_perm();
+        void load_sparse_SV (alps::hdf5::archive & ar, size_t l) {
+            std::vector<int> SV_offset, SV_column;
+            std::vector<double> SV_value;
+            ar["SV_offset"] >> SV_offset;
+            if (SV_offset.size() != l + 1 || SV_offset.front() != 0)
+                throw std::runtime_error("inconsistent data length");
+            size_t nnz = SV_offset.back();
+            if (nnz > 0) {
+                ar["SV_column"] >> SV_column;
+                ar["SV_value"] >> SV_value;
+            }
+            if (SV_column.size() != nnz || SV_value.size() != nnz)
+                throw std::runtime_error("inconsistent data length");
+            for (size_t i = 0; i < l; ++i)
+                if (SV_offset[i] > SV_offset[i+1])
+                    throw std::runtime_error("inconsistent data length");
+            for (int column : SV_column)
+                if (column < 0 || size_t(column) >= model_.prob.dim())
+                    throw std::runtime_error("inconsistent data dimension");
+            if (l == 0)
+                return;
+
+            struct svm_node * node = (struct svm_node *)malloc(sizeof(struct svm_node) * (nnz + l));
+            for (size_t i = 0; i < l; ++i) {
+                model_.m->SV[i] = node;
+                for (int k = SV_offset[i]; k < SV_offset[i+1]; ++k, ++node) {
+                    node->index = SV_column[k] + 1;
+                    node->value = SV_value[k];
+                }
+                node->index = -1;
+                node->value = 0;
+                ++node;
+            }
         }
 
-    private:
         using problem_t = typename Model::problem_t;
         Model & model_;
         problem_serializer<hdf5_tag, problem_t> prob_serializer;
@@ -264,12 +313,9 @@ namespace serialization {
         }
 
         void save (alps::hdf5::archive & ar) const {
-            using input_t = typename Problem::input_container_type;
             using label_t = typename Problem::label_type;
             using ltraits = typename::svm::traits::label_traits<label_t>;
-            using view_t = typename std::conditional<
-                std::is_same<svm::dataset, input_t>::value,
-                svm::data_view, input_t const&>::type;
+            using view_t = decltype(std::declval<Problem const&>().view(0).first);
 
             ar["dim"] << prob_.dim();
 
@@ -278,7 +324,7 @@ namespace serialization {
                 boost::multi_array<double, 2> labels(boost::extents[prob_.size()][ltraits::label_dim]);
 
                 for (size_t i = 0; i < prob_.size(); ++i) {
-                    auto p = prob_[i];
+                    auto p = prob_.view(i);
                     view_t xs = p.first;
                     label_t const& l = p.second;
                     std::copy(xs.begin(), xs.end(), orig_data[i].begin());
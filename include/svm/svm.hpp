@@ -19,6 +19,7 @@
 #pragma once
 
 #include <svm/dataset.hpp>
+#include <svm/fixed_dataset.hpp>
 #include <svm/kernel.hpp>
 #include <svm/label.hpp>
 #include <svm/model.hpp>
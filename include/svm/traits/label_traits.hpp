@@ -27,6 +27,15 @@ namespace svm {
 
     static constexpr size_t DYNAMIC = std::numeric_limits<size_t>::max();
 
+    // dimension of problems and models whose samples are dense vectors of a
+    // dimension given at runtime
+    static constexpr size_t DENSE = DYNAMIC - 1;
+
+    // whether the dimension Dim of the samples is fixed at compile time
+    constexpr bool is_fixed_dim (size_t Dim) {
+        return Dim != DYNAMIC && Dim != DENSE;
+    }
+
     namespace traits {
 
         template <typename...>
@@ -38,7 +38,11 @@
 #include <stdarg.h>
 #include <limits.h>
 #include <locale.h>
+#include <time.h>
 #include <svm/libsvm/svm.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 int libsvm_version = LIBSVM_VERSION;
 typedef float Qfloat;
 typedef signed char schar;
@@ -75,6 +79,16 @@ static void print_string_stdout(const char *s)
 	fflush(stdout);
 }
 static void (*svm_print_string) (const char *) = &print_string_stdout;
+static void (*svm_train_report) (int, int, int, double, double) = NULL;
+
+static double wall_time()
+{
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
 #if 0
 static void info(const char *fmt,...)
 {
@@ -89,16 +103,56 @@ static void info(const char *fmt,...)
 static void info(const char *,...) {}
 #endif
 
+//
+// Memory budget shared by the kernel caches of concurrent solvers
+//
+// Each cache registers with its number of data items as weight and may use
+// a share of size bytes in proportion to its weight among the registered
+// caches. Shares are looked up whenever a cache needs more space, so that
+// the remaining caches grow as others are released.
+//
+class CacheBudget
+{
+public:
+	CacheBudget(long int size):size(size),weight(0) {}
+	void enter(long int w);
+	void leave(long int w);
+	long int share(long int w) const;
+private:
+	long int size;
+	long int weight;
+};
+
+void CacheBudget::enter(long int w)
+{
+#pragma omp critical(svm_cache_budget)
+	weight += w;
+}
+
+void CacheBudget::leave(long int w)
+{
+#pragma omp critical(svm_cache_budget)
+	weight -= w;
+}
+
+long int CacheBudget::share(long int w) const
+{
+	long int total;
+#pragma omp critical(svm_cache_budget)
+	total = weight;
+	return total > w ? (long int)((double)size * w / total) : size;
+}
+
 //
 // Kernel Cache
 //
 // l is the number of total data items
-// size is the cache size limit in bytes
+// size is the cache size limit in bytes, unless a budget is given
 //
 class Cache
 {
 public:
-	Cache(int l,long int size);
+	Cache(int l,long int size,CacheBudget *budget);
 	~Cache();
 
 	// request data [0,len)
@@ -108,7 +162,9 @@ public:
 	void swap_index(int i, int j);
 private:
 	int l;
-	long int size;
+	long int size;	// free space
+	long int limit;
+	CacheBudget *budget;
 	struct head_t
 	{
 		head_t *prev, *next;	// a circular list
@@ -120,14 +176,18 @@ private:
 	head_t lru_head;
 	void lru_delete(head_t *h);
 	void lru_insert(head_t *h);
+	void set_limit(long int bytes);
 };
 
-Cache::Cache(int l_,long int size_):l(l_),size(size_)
+Cache::Cache(int l_,long int size_,CacheBudget *budget_):l(l_),size(0),limit(0),budget(budget_)
 {
 	head = (head_t *)calloc(l,sizeof(head_t));	// initialized to 0
-	size /= sizeof(Qfloat);
-	size -= l * sizeof(head_t) / sizeof(Qfloat);
-	size = max(size, 2 * (long int) l);	// cache must be large enough for two columns
+	if(budget)
+	{
+		budget->enter(l);
+		size_ = budget->share(l);
+	}
+	set_limit(size_);
 	lru_head.next = lru_head.prev = &lru_head;
 }
 
@@ -136,6 +196,16 @@ Cache::~Cache()
 	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
 		free(h->data);
 	free(head);
+	if(budget) budget->leave(l);
+}
+
+void Cache::set_limit(long int bytes)
+{
+	bytes /= sizeof(Qfloat);
+	bytes -= l * sizeof(head_t) / sizeof(Qfloat);
+	bytes = max(bytes, 2 * (long int) l);	// cache must be large enough for two columns
+	size += bytes - limit;
+	limit = bytes;
 }
 
 void Cache::lru_delete(head_t *h)
@@ -162,6 +232,8 @@ int Cache::get_data(const int index, Qfloat **data, int len)
 
 	if(more > 0)
 	{
+		if(budget) set_limit(budget->share(l));
+
 		// free old space
 		while(size < more)
 		{
@@ -215,16 +287,217 @@ void Cache::swap_index(int i, int j)
 	}
 }
 
+//
+// Kernel cache shared by the one-vs-one subproblems of multiclass training
+//
+// The samples are given in the grouped order of svm_train, i.e. class by
+// class. Row a holds K(x_a,x_b) for all b in the class of a, which is needed
+// by each of the subproblems involving that class, so it is computed only
+// once. The diagonal of the kernel matrix is likewise shared. Rows in use by
+// some solver are pinned and are not evicted until they are unlocked.
+//
+class ClassCache
+{
+public:
+	ClassCache(int l, svm_node * const *x, int nr_class, const int *start,
+		   const int *count, CacheBudget *budget);
+	~ClassCache();
+
+	// computes x_square (if needed) and the diagonal QD
+	template <class KernelFunction, class Samples>
+	void compute_diagonal(const KernelFunction& kernel, const Samples& samples, bool rbf)
+	{
+		if(rbf)
+		{
+			x_square = new double[l];
+			for(int i=0;i<l;i++)
+				x_square[i] = samples.dot(i,i);
+		}
+		for(int i=0;i<l;i++)
+			QD[i] = kernel(samples,x_square,i,i);
+	}
+
+	// the row of sample a starts at the first sample of its class
+	int row_start(int a) const { return start[group[a]]; }
+	int row_len(int a) const { return count[group[a]]; }
+
+	// return the pinned row of a, or NULL if it is not cached
+	const Qfloat *lock_row(int a);
+	// cache the newly computed row of a, or discard it if another solver
+	// was faster, and return the cached row pinned
+	const Qfloat *insert_row(int a, Qfloat *data);
+	void unlock_row(int a);
+
+	const svm_node * const *x;
+	double *x_square;
+	double *QD;
+	CacheBudget *budget;	// shared with the subproblems' caches
+private:
+	int l;
+	long int size;	// free space
+	long int limit;
+	int *group;
+	const int *start;
+	const int *count;
+	struct head_t
+	{
+		head_t *prev, *next;	// a circular list
+		Qfloat *data;
+		int pins;
+	};
+
+	head_t *head;
+	head_t lru_head;
+	void lru_delete(head_t *h);
+	void lru_insert(head_t *h);
+};
+
+ClassCache::ClassCache(int l_, svm_node * const *x_, int nr_class, const int *start_,
+		       const int *count_, CacheBudget *budget_)
+:x(x_), x_square(0), budget(budget_), l(l_), size(0), limit(0), start(start_), count(count_)
+{
+	QD = new double[l];
+	group = new int[l];
+	for(int c=0;c<nr_class;c++)
+		for(int i=start[c];i<start[c]+count[c];i++)
+			group[i] = c;
+	head = (head_t *)calloc(l,sizeof(head_t));	// initialized to 0
+	budget->enter(l);
+	lru_head.next = lru_head.prev = &lru_head;
+}
+
+ClassCache::~ClassCache()
+{
+	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
+		free(h->data);
+	free(head);
+	budget->leave(l);
+	delete[] group;
+	delete[] x_square;
+	delete[] QD;
+}
+
+void ClassCache::lru_delete(head_t *h)
+{
+	h->prev->next = h->next;
+	h->next->prev = h->prev;
+}
+
+void ClassCache::lru_insert(head_t *h)
+{
+	h->next = &lru_head;
+	h->prev = lru_head.prev;
+	h->prev->next = h;
+	h->next->prev = h;
+}
+
+const Qfloat *ClassCache::lock_row(int a)
+{
+	const Qfloat *data = NULL;
+#pragma omp critical(svm_class_cache)
+	{
+		head_t *h = &head[a];
+		if(h->data)
+		{
+			++h->pins;
+			lru_delete(h);
+			lru_insert(h);
+			data = h->data;
+		}
+	}
+	return data;
+}
+
+const Qfloat *ClassCache::insert_row(int a, Qfloat *data)
+{
+	const Qfloat *ret;
+	long int bytes = budget->share(l);
+#pragma omp critical(svm_class_cache)
+	{
+		bytes /= sizeof(Qfloat);
+		bytes -= l * sizeof(head_t) / sizeof(Qfloat);
+		size += bytes - limit;
+		limit = bytes;
+
+		head_t *h = &head[a];
+		if(h->data)
+		{
+			free(data);
+			lru_delete(h);
+		}
+		else
+		{
+			// evict unpinned rows; if all are pinned, exceed the budget
+			// until they are released
+			long int len = row_len(a);
+			head_t *old = lru_head.next;
+			while(size < len && old != &lru_head)
+			{
+				head_t *next = old->next;
+				if(!old->pins)
+				{
+					lru_delete(old);
+					free(old->data);
+					size += row_len(old - head);
+					old->data = 0;
+				}
+				old = next;
+			}
+			h->data = data;
+			size -= len;
+		}
+		++h->pins;
+		lru_insert(h);
+		ret = h->data;
+	}
+	return ret;
+}
+
+void ClassCache::unlock_row(int a)
+{
+#pragma omp critical(svm_class_cache)
+	--head[a].pins;
+}
+
+// kernel columns of n missing entries are filled in parallel, unless they are
+// short or the solver is already running in parallel with others
+static inline bool parallel_fill(int n)
+{
+#ifdef _OPENMP
+	return n >= 1024 && !omp_in_parallel();
+#else
+	(void)n;
+	return false;
+#endif
+}
+
+// a subproblem whose training vectors are the samples index[0,l) of cache,
+// unless cache is NULL, and whose kernel cache draws on budget
+struct shared_kernel
+{
+	ClassCache *cache;
+	const int *index;
+	CacheBudget *budget;
+};
+
 //
 // Kernel evaluation
 //
 // the static method k_function is for doing single kernel evaluation
 // the constructor of Kernel prepares to calculate the l*l kernel matrix
 // the member function get_Q is for getting one column from the Q Matrix
+// and get_Q_pair for getting two columns at once, as nu-SVM's working set
+// selection needs
 //
 class QMatrix {
 public:
 	virtual Qfloat *get_Q(int column, int len) const = 0;
+	virtual void get_Q_pair(int i, int j, int len, Qfloat **Q_i, Qfloat **Q_j) const
+	{
+		// the cache always holds at least two columns
+		*Q_i = get_Q(i,len);
+		*Q_j = get_Q(j,len);
+	}
 	virtual double *get_QD() const = 0;
 	virtual void swap_index(int i, int j) const = 0;
 	virtual ~QMatrix() {}
@@ -232,11 +505,16 @@ public:
 
 class Kernel: public QMatrix {
 public:
-	Kernel(int l, svm_node * const * x, const svm_parameter& param);
+	Kernel(int l, svm_node * const * x, const svm_parameter& param, int dense_dim);
 	virtual ~Kernel();
 
 	static double k_function(const svm_node *x, const svm_node *y,
 				 const svm_parameter& param);
+	static double dot(const svm_node *px, const svm_node *py);
+	static double dot(const double *x, const double *y, int n);
+	static double dot(const double *x, int n, const svm_node *py);
+	static double distance_squared(const svm_node *x, const svm_node *y);
+	static double distance_squared(const double *x, int n, const svm_node *y);
 	virtual Qfloat *get_Q(int column, int len) const = 0;
 	virtual double *get_QD() const = 0;
 	virtual void swap_index(int i, int j) const	// no so const...
@@ -245,72 +523,27 @@ public:
 		if(x_square) swap(x_square[i],x_square[j]);
 	}
 protected:
-
-	double (Kernel::*kernel_function)(int i, int j) const;
-
-private:
 	const svm_node **x;
 	double *x_square;
-
-	// svm_parameter
-	const int kernel_type;
-	const int degree;
-	const double gamma;
-	const double coef0;
-
-	static double dot(const svm_node *px, const svm_node *py);
-	double kernel_linear(int i, int j) const
-	{
-		return dot(x[i],x[j]);
-	}
-	double kernel_poly(int i, int j) const
-	{
-		return powi(gamma*dot(x[i],x[j])+coef0,degree);
-	}
-	double kernel_rbf(int i, int j) const
-	{
-		return exp(-gamma*(x_square[i]+x_square[j]-2*dot(x[i],x[j])));
-	}
-	double kernel_sigmoid(int i, int j) const
-	{
-		return tanh(gamma*dot(x[i],x[j])+coef0);
-	}
-	double kernel_precomputed(int i, int j) const
-	{
-		return x[i][(int)(x[j][0].value)].value;
-	}
 };
 
-Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
-:kernel_type(param.kernel_type), degree(param.degree),
- gamma(param.gamma), coef0(param.coef0)
+// dense_dim > 0 means that each x[i] points to a dense row of dense_dim
+// doubles rather than to an svm_node array (see svm_train_dense)
+Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param, int dense_dim)
 {
-	switch(kernel_type)
-	{
-		case LINEAR:
-			kernel_function = &Kernel::kernel_linear;
-			break;
-		case POLY:
-			kernel_function = &Kernel::kernel_poly;
-			break;
-		case RBF:
-			kernel_function = &Kernel::kernel_rbf;
-			break;
-		case SIGMOID:
-			kernel_function = &Kernel::kernel_sigmoid;
-			break;
-		case PRECOMPUTED:
-			kernel_function = &Kernel::kernel_precomputed;
-			break;
-	}
-
 	clone(x,x_,l);
 
-	if(kernel_type == RBF)
+	if(param.kernel_type == RBF)
 	{
 		x_square = new double[l];
 		for(int i=0;i<l;i++)
-			x_square[i] = dot(x[i],x[i]);
+			if(dense_dim > 0)
+			{
+				const double *row = (const double *)x[i];
+				x_square[i] = dot(row,row,dense_dim);
+			}
+			else
+				x_square[i] = dot(x[i],x[i]);
 	}
 	else
 		x_square = 0;
@@ -344,65 +577,299 @@ double Kernel::dot(const svm_node *px, const svm_node *py)
 	return sum;
 }
 
-double Kernel::k_function(const svm_node *x, const svm_node *y,
-			  const svm_parameter& param)
+double Kernel::dot(const double *x, const double *y, int n)
 {
-	switch(param.kernel_type)
+	double sum = 0;
+#pragma omp simd reduction(+:sum)
+	for(int k=0;k<n;k++)
+		sum += x[k] * y[k];
+	return sum;
+}
+
+// dense x against sparse y; indices of y beyond n are zero in x
+double Kernel::dot(const double *x, int n, const svm_node *py)
+{
+	double sum = 0;
+	for(;py->index != -1 && py->index <= n;++py)
+		sum += x[py->index-1] * py->value;
+	return sum;
+}
+
+double Kernel::distance_squared(const svm_node *x, const svm_node *y)
+{
+	double sum = 0;
+	while(x->index != -1 && y->index !=-1)
 	{
-		case LINEAR:
-			return dot(x,y);
-		case POLY:
-			return powi(param.gamma*dot(x,y)+param.coef0,param.degree);
-		case RBF:
+		if(x->index == y->index)
 		{
-			double sum = 0;
-			while(x->index != -1 && y->index !=-1)
-			{
-				if(x->index == y->index)
-				{
-					double d = x->value - y->value;
-					sum += d*d;
-					++x;
-					++y;
-				}
-				else
-				{
-					if(x->index > y->index)
-					{	
-						sum += y->value * y->value;
-						++y;
-					}
-					else
-					{
-						sum += x->value * x->value;
-						++x;
-					}
-				}
+			double d = x->value - y->value;
+			sum += d*d;
+			++x;
+			++y;
+		}
+		else
+		{
+			if(x->index > y->index)
+			{	
+				sum += y->value * y->value;
+				++y;
 			}
-
-			while(x->index != -1)
+			else
 			{
 				sum += x->value * x->value;
 				++x;
 			}
+		}
+	}
+
+	while(x->index != -1)
+	{
+		sum += x->value * x->value;
+		++x;
+	}
+
+	while(y->index != -1)
+	{
+		sum += y->value * y->value;
+		++y;
+	}
+
+	return sum;
+}
+
+double Kernel::distance_squared(const double *x, int n, const svm_node *y)
+{
+	double sum = 0;
+	for(int k=0;k<n;k++)
+	{
+		double d = x[k];
+		if(y->index == k+1)
+		{
+			d -= y->value;
+			++y;
+		}
+		sum += d*d;
+	}
+	for(;y->index != -1;++y)
+		sum += y->value * y->value;
+	return sum;
+}
+
+//
+// Training vectors
+//
+// The Q matrices access the training vectors through one of these, either
+// as svm_node arrays or as dense rows of dim doubles (see svm_train_dense).
+//
+struct SparseSamples
+{
+	SparseSamples(const svm_node * const *x, int) :x(x) {}
+	double dot(int i, int j) const
+	{
+		return Kernel::dot(x[i],x[j]);
+	}
+	const svm_node *operator[](int i) const
+	{
+		return x[i];
+	}
+private:
+	const svm_node * const *x;
+};
+
+struct DenseSamples
+{
+	DenseSamples(const svm_node * const *x, int dim) :x(x), dim(dim) {}
+	double dot(int i, int j) const
+	{
+		return Kernel::dot((const double *)x[i],(const double *)x[j],dim);
+	}
+private:
+	const svm_node * const *x;
+	const int dim;
+};
 
-			while(y->index != -1)
+//
+// Kernel functions
+//
+// The Q matrices and the prediction are instantiated for each of these, such
+// that the kernel is resolved at compile time rather than per evaluation.
+// operator()(x, x_square, i, j) evaluates the kernel of training vectors x[i]
+// and x[j] (x_square holds their squared norms for the RBF kernel only),
+// operator()(x, y) evaluates it for a single pair of vectors and
+// operator()(x, n, y) for a dense vector x of length n and a sparse one y.
+//
+struct LinearKernel
+{
+	explicit LinearKernel(const svm_parameter&) {}
+	template <class Samples>
+	double operator()(const Samples& x, const double *, int i, int j) const
+	{
+		return x.dot(i,j);
+	}
+	double operator()(const svm_node *x, const svm_node *y) const
+	{
+		return Kernel::dot(x,y);
+	}
+	double operator()(const double *x, int n, const svm_node *y) const
+	{
+		return Kernel::dot(x,n,y);
+	}
+};
+
+// Degree == 0 takes the degree from the parameters at runtime
+template <int Degree>
+struct PolyKernel
+{
+	explicit PolyKernel(const svm_parameter& param)
+	:gamma(param.gamma), coef0(param.coef0), degree(Degree ? Degree : param.degree) {}
+	template <class Samples>
+	double operator()(const Samples& x, const double *, int i, int j) const
+	{
+		return powi(gamma*x.dot(i,j)+coef0,Degree ? Degree : degree);
+	}
+	double operator()(const svm_node *x, const svm_node *y) const
+	{
+		return powi(gamma*Kernel::dot(x,y)+coef0,Degree ? Degree : degree);
+	}
+	double operator()(const double *x, int n, const svm_node *y) const
+	{
+		return powi(gamma*Kernel::dot(x,n,y)+coef0,Degree ? Degree : degree);
+	}
+private:
+	const double gamma;
+	const double coef0;
+	const int degree;
+};
+
+struct RbfKernel
+{
+	explicit RbfKernel(const svm_parameter& param) :gamma(param.gamma) {}
+	template <class Samples>
+	double operator()(const Samples& x, const double *x_square, int i, int j) const
+	{
+		return exp(-gamma*(x_square[i]+x_square[j]-2*x.dot(i,j)));
+	}
+	double operator()(const svm_node *x, const svm_node *y) const
+	{
+		return exp(-gamma*Kernel::distance_squared(x,y));
+	}
+	double operator()(const double *x, int n, const svm_node *y) const
+	{
+		return exp(-gamma*Kernel::distance_squared(x,n,y));
+	}
+private:
+	const double gamma;
+};
+
+struct SigmoidKernel
+{
+	explicit SigmoidKernel(const svm_parameter& param)
+	:gamma(param.gamma), coef0(param.coef0) {}
+	template <class Samples>
+	double operator()(const Samples& x, const double *, int i, int j) const
+	{
+		return tanh(gamma*x.dot(i,j)+coef0);
+	}
+	double operator()(const svm_node *x, const svm_node *y) const
+	{
+		return tanh(gamma*Kernel::dot(x,y)+coef0);
+	}
+	double operator()(const double *x, int n, const svm_node *y) const
+	{
+		return tanh(gamma*Kernel::dot(x,n,y)+coef0);
+	}
+private:
+	const double gamma;
+	const double coef0;
+};
+
+struct PrecomputedKernel
+{
+	explicit PrecomputedKernel(const svm_parameter&) {}
+	double operator()(const SparseSamples& x, const double *, int i, int j) const
+	{
+		return (*this)(x[i],x[j]);
+	}
+	double operator()(const svm_node *x, const svm_node *y) const  //x: test (validation), y: SV
+	{
+		return x[(int)(y->value)].value;
+	}
+	double operator()(const double *x, int, const svm_node *y) const
+	{
+		return x[(int)(y->value)-1];
+	}
+};
+
+// calls f with the kernel function selected by param; polynomial kernels of
+// low degree get the degree as a compile-time constant
+template <class F>
+static void with_kernel_function(const svm_parameter& param, F f)
+{
+	switch(param.kernel_type)
+	{
+		case LINEAR:
+			f(LinearKernel(param));
+			break;
+		case POLY:
+			switch(param.degree)
 			{
-				sum += y->value * y->value;
-				++y;
+				case 1: f(PolyKernel<1>(param)); break;
+				case 2: f(PolyKernel<2>(param)); break;
+				case 3: f(PolyKernel<3>(param)); break;
+				case 4: f(PolyKernel<4>(param)); break;
+				default: f(PolyKernel<0>(param)); break;
 			}
-			
-			return exp(-param.gamma*sum);
-		}
+			break;
+		case RBF:
+			f(RbfKernel(param));
+			break;
 		case SIGMOID:
-			return tanh(param.gamma*dot(x,y)+param.coef0);
-		case PRECOMPUTED:  //x: test (validation), y: SV
-			return x[(int)(y->value)].value;
-		default:
-			return 0;  // Unreachable 
+			f(SigmoidKernel(param));
+			break;
+		case PRECOMPUTED:
+			f(PrecomputedKernel(param));
+			break;
 	}
 }
 
+template <class T> struct type_tag { typedef T type; };
+
+template <class F, class K>
+static void with_samples(F& f, const K& kernel, int dense_dim)
+{
+	if(dense_dim > 0)
+		f(kernel, type_tag<DenseSamples>());
+	else
+		f(kernel, type_tag<SparseSamples>());
+}
+
+// precomputed kernel values are only ever given as svm_node arrays
+template <class F>
+static void with_samples(F& f, const PrecomputedKernel& kernel, int)
+{
+	f(kernel, type_tag<SparseSamples>());
+}
+
+// calls f with the kernel function selected by param and a type_tag of the
+// access to the training vectors, which are dense rows if dense_dim > 0
+template <class F>
+static void with_training_kernel(const svm_parameter& param, int dense_dim, F f)
+{
+	with_kernel_function(param, [&](const auto& kernel) {
+		with_samples(f, kernel, dense_dim);
+	});
+}
+
+double Kernel::k_function(const svm_node *x, const svm_node *y,
+			  const svm_parameter& param)
+{
+	double ret = 0;
+	with_kernel_function(param, [&](const auto& kernel) {
+		ret = kernel(x,y);
+	});
+	return ret;
+}
+
 // An SMO algorithm in Fan et al., JMLR 6(2005), p. 1889--1918
 // Solves:
 //
@@ -1095,11 +1562,13 @@ int Solver_NU::select_working_set(int &out_i, int &out_j)
 
 	int ip = Gmaxp_idx;
 	int in = Gmaxn_idx;
-	const Qfloat *Q_ip = NULL;
-	const Qfloat *Q_in = NULL;
-	if(ip != -1) // NULL Q_ip not accessed: Gmaxp=-INF if ip=-1
+	Qfloat *Q_ip = NULL;
+	Qfloat *Q_in = NULL;
+	if(ip != -1 && in != -1)
+		Q->get_Q_pair(ip,in,active_size,&Q_ip,&Q_in);
+	else if(ip != -1) // NULL Q_ip not accessed: Gmaxp=-INF if ip=-1
 		Q_ip = Q->get_Q(ip,active_size);
-	if(in != -1)
+	else if(in != -1)
 		Q_in = Q->get_Q(in,active_size);
 
 	for(int j=0;j<active_size;j++)
@@ -1291,31 +1760,69 @@ double Solver_NU::calculate_rho()
 //
 // Q matrices for various formulations
 //
+template <class KernelFunction, class Samples>
 class SVC_Q: public Kernel
 { 
 public:
-	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_)
-	:Kernel(prob.l, prob.x, param)
+	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_, int dense_dim,
+	      const shared_kernel *shared)
+	:Kernel(prob.l, prob.x, param, dense_dim), kernel(param), samples(x, dense_dim),
+	 shared_samples(shared && shared->cache ? shared->cache->x : x, dense_dim),
+	 shared_cache(shared ? shared->cache : NULL), index(NULL)
 	{
 		clone(y,y_,prob.l);
-		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
+		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)),
+				  shared ? shared->budget : NULL);
 		QD = new double[prob.l];
-		for(int i=0;i<prob.l;i++)
-			QD[i] = (this->*kernel_function)(i,i);
+		if(shared_cache)
+		{
+			clone(index,shared->index,prob.l);
+			for(int i=0;i<prob.l;i++)
+				QD[i] = shared_cache->QD[index[i]];
+		}
+		else
+			for(int i=0;i<prob.l;i++)
+				QD[i] = kernel(samples,x_square,i,i);
 	}
 	
 	Qfloat *get_Q(int i, int len) const
 	{
 		Qfloat *data;
-		int start, j;
+		int start;
 		if((start = cache->get_data(i,&data,len)) < len)
 		{
-			for(j=start;j<len;j++)
-				data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
+			if(shared_cache)
+				fill_shared(i,data,start,len);
+			else
+				fill(i,data,start,len);
 		}
 		return data;
 	}
 
+	// the entries missing from both columns are computed in a single pass
+	// over the training vectors, such that each is loaded only once
+	void get_Q_pair(int i, int j, int len, Qfloat **Q_i, Qfloat **Q_j) const
+	{
+		if(shared_cache)
+		{
+			// the same-class entries are copied from the shared rows
+			QMatrix::get_Q_pair(i,j,len,Q_i,Q_j);
+			return;
+		}
+		int start_i = cache->get_data(i,Q_i,len);
+		int start_j = cache->get_data(j,Q_j,len);
+		int start = max(start_i,start_j);
+		Qfloat *data_i = *Q_i, *data_j = *Q_j;
+		fill(i,data_i,start_i,start);
+		fill(j,data_j,start_j,start);
+#pragma omp parallel for schedule(static) if(parallel_fill(len-start))
+		for(int k=start;k<len;k++)
+		{
+			data_i[k] = (Qfloat)(y[i]*y[k]*kernel(samples,x_square,i,k));
+			data_j[k] = (Qfloat)(y[j]*y[k]*kernel(samples,x_square,j,k));
+		}
+	}
+
 	double *get_QD() const
 	{
 		return QD;
@@ -1327,6 +1834,7 @@ public:
 		Kernel::swap_index(i,j);
 		swap(y[i],y[j]);
 		swap(QD[i],QD[j]);
+		if(index) swap(index[i],index[j]);
 	}
 
 	~SVC_Q()
@@ -1334,23 +1842,61 @@ public:
 		delete[] y;
 		delete cache;
 		delete[] QD;
+		delete[] index;
 	}
 private:
+	void fill(int i, Qfloat *data, int start, int len) const
+	{
+#pragma omp parallel for schedule(static) if(parallel_fill(len-start))
+		for(int j=start;j<len;j++)
+			data[j] = (Qfloat)(y[i]*y[j]*kernel(samples,x_square,i,j));
+	}
+
+	// entries within the class of i are taken from the shared row of i
+	void fill_shared(int i, Qfloat *data, int start, int len) const
+	{
+		int a = index[i];
+		int s = shared_cache->row_start(a);
+		const Qfloat *row = shared_cache->lock_row(a);
+		if(!row)
+		{
+			int n = shared_cache->row_len(a);
+			Qfloat *new_row = Malloc(Qfloat,n);
+#pragma omp parallel for schedule(static) if(parallel_fill(n))
+			for(int b=0;b<n;b++)
+				new_row[b] = (Qfloat)kernel(shared_samples,shared_cache->x_square,a,s+b);
+			row = shared_cache->insert_row(a,new_row);
+		}
+#pragma omp parallel for schedule(static) if(parallel_fill(len-start))
+		for(int j=start;j<len;j++)
+			if(y[j] == y[i])
+				data[j] = row[index[j]-s];
+			else
+				data[j] = (Qfloat)(y[i]*y[j]*kernel(samples,x_square,i,j));
+		shared_cache->unlock_row(a);
+	}
+
+	const KernelFunction kernel;
+	const Samples samples;
+	const Samples shared_samples;
+	ClassCache *shared_cache;
+	int *index;
 	schar *y;
 	Cache *cache;
 	double *QD;
 };
 
+template <class KernelFunction, class Samples>
 class ONE_CLASS_Q: public Kernel
 {
 public:
-	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param)
-	:Kernel(prob.l, prob.x, param)
+	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param, int dense_dim)
+	:Kernel(prob.l, prob.x, param, dense_dim), kernel(param), samples(x, dense_dim)
 	{
-		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
+		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)),NULL);
 		QD = new double[prob.l];
 		for(int i=0;i<prob.l;i++)
-			QD[i] = (this->*kernel_function)(i,i);
+			QD[i] = kernel(samples,x_square,i,i);
 	}
 	
 	Qfloat *get_Q(int i, int len) const
@@ -1359,8 +1905,9 @@ public:
 		int start, j;
 		if((start = cache->get_data(i,&data,len)) < len)
 		{
+#pragma omp parallel for schedule(static) if(parallel_fill(len-start))
 			for(j=start;j<len;j++)
-				data[j] = (Qfloat)(this->*kernel_function)(i,j);
+				data[j] = (Qfloat)kernel(samples,x_square,i,j);
 		}
 		return data;
 	}
@@ -1383,18 +1930,21 @@ public:
 		delete[] QD;
 	}
 private:
+	const KernelFunction kernel;
+	const Samples samples;
 	Cache *cache;
 	double *QD;
 };
 
+template <class KernelFunction, class Samples>
 class SVR_Q: public Kernel
 { 
 public:
-	SVR_Q(const svm_problem& prob, const svm_parameter& param)
-	:Kernel(prob.l, prob.x, param)
+	SVR_Q(const svm_problem& prob, const svm_parameter& param, int dense_dim)
+	:Kernel(prob.l, prob.x, param, dense_dim), kernel(param), samples(x, dense_dim)
 	{
 		l = prob.l;
-		cache = new Cache(l,(long int)(param.cache_size*(1<<20)));
+		cache = new Cache(l,(long int)(param.cache_size*(1<<20)),NULL);
 		QD = new double[2*l];
 		sign = new schar[2*l];
 		index = new int[2*l];
@@ -1404,7 +1954,7 @@ public:
 			sign[k+l] = -1;
 			index[k] = k;
 			index[k+l] = k;
-			QD[k] = (this->*kernel_function)(k,k);
+			QD[k] = kernel(samples,x_square,k,k);
 			QD[k+l] = QD[k];
 		}
 		buffer[0] = new Qfloat[2*l];
@@ -1425,8 +1975,9 @@ public:
 		int j, real_i = index[i];
 		if(cache->get_data(real_i,&data,l) < l)
 		{
+#pragma omp parallel for schedule(static) if(parallel_fill(l))
 			for(j=0;j<l;j++)
-				data[j] = (Qfloat)(this->*kernel_function)(real_i,j);
+				data[j] = (Qfloat)kernel(samples,x_square,real_i,j);
 		}
 
 		// reorder and copy
@@ -1453,6 +2004,8 @@ public:
 		delete[] QD;
 	}
 private:
+	const KernelFunction kernel;
+	const Samples samples;
 	int l;
 	Cache *cache;
 	schar *sign;
@@ -1467,7 +2020,8 @@ private:
 //
 static void solve_c_svc(
 	const svm_problem *prob, const svm_parameter* param,
-	double *alpha, Solver::SolutionInfo* si, double Cp, double Cn)
+	double *alpha, Solver::SolutionInfo* si, double Cp, double Cn, int dense_dim,
+	const shared_kernel *shared)
 {
 	int l = prob->l;
 	double *minus_ones = new double[l];
@@ -1483,8 +2037,12 @@ static void solve_c_svc(
 	}
 
 	Solver s;
-	s.Solve(l, SVC_Q(*prob,*param,y), minus_ones, y,
-		alpha, Cp, Cn, param->eps, si, param->shrinking);
+	with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+		typedef decltype(kernel) K;
+		typedef typename decltype(samples)::type S;
+		s.Solve(l, SVC_Q<K,S>(*prob,*param,y,dense_dim,shared), minus_ones, y,
+			alpha, Cp, Cn, param->eps, si, param->shrinking);
+	});
 
 	double sum_alpha=0;
 	for(i=0;i<l;i++)
@@ -1502,7 +2060,8 @@ static void solve_c_svc(
 
 static void solve_nu_svc(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, int dense_dim,
+	const shared_kernel *shared)
 {
 	int i;
 	int l = prob->l;
@@ -1537,8 +2096,12 @@ static void solve_nu_svc(
 		zeros[i] = 0;
 
 	Solver_NU s;
-	s.Solve(l, SVC_Q(*prob,*param,y), zeros, y,
-		alpha, 1.0, 1.0, param->eps, si,  param->shrinking);
+	with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+		typedef decltype(kernel) K;
+		typedef typename decltype(samples)::type S;
+		s.Solve(l, SVC_Q<K,S>(*prob,*param,y,dense_dim,shared), zeros, y,
+			alpha, 1.0, 1.0, param->eps, si,  param->shrinking);
+	});
 	double r = si->r;
 
 	info("C = %f\n",1/r);
@@ -1557,7 +2120,7 @@ static void solve_nu_svc(
 
 static void solve_one_class(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, int dense_dim)
 {
 	int l = prob->l;
 	double *zeros = new double[l];
@@ -1580,8 +2143,12 @@ static void solve_one_class(
 	}
 
 	Solver s;
-	s.Solve(l, ONE_CLASS_Q(*prob,*param), zeros, ones,
-		alpha, 1.0, 1.0, param->eps, si, param->shrinking);
+	with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+		typedef decltype(kernel) K;
+		typedef typename decltype(samples)::type S;
+		s.Solve(l, ONE_CLASS_Q<K,S>(*prob,*param,dense_dim), zeros, ones,
+			alpha, 1.0, 1.0, param->eps, si, param->shrinking);
+	});
 
 	delete[] zeros;
 	delete[] ones;
@@ -1589,7 +2156,7 @@ static void solve_one_class(
 
 static void solve_epsilon_svr(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, int dense_dim)
 {
 	int l = prob->l;
 	double *alpha2 = new double[2*l];
@@ -1609,8 +2176,12 @@ static void solve_epsilon_svr(
 	}
 
 	Solver s;
-	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
-		alpha2, param->C, param->C, param->eps, si, param->shrinking);
+	with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+		typedef decltype(kernel) K;
+		typedef typename decltype(samples)::type S;
+		s.Solve(2*l, SVR_Q<K,S>(*prob,*param,dense_dim), linear_term, y,
+			alpha2, param->C, param->C, param->eps, si, param->shrinking);
+	});
 
 	double sum_alpha = 0;
 	for(i=0;i<l;i++)
@@ -1627,7 +2198,7 @@ static void solve_epsilon_svr(
 
 static void solve_nu_svr(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, int dense_dim)
 {
 	int l = prob->l;
 	double C = param->C;
@@ -1650,8 +2221,12 @@ static void solve_nu_svr(
 	}
 
 	Solver_NU s;
-	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
-		alpha2, C, C, param->eps, si, param->shrinking);
+	with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+		typedef decltype(kernel) K;
+		typedef typename decltype(samples)::type S;
+		s.Solve(2*l, SVR_Q<K,S>(*prob,*param,dense_dim), linear_term, y,
+			alpha2, C, C, param->eps, si, param->shrinking);
+	});
 
 	info("epsilon = %f\n",-si->r);
 
@@ -1674,26 +2249,26 @@ struct decision_function
 
 static decision_function svm_train_one(
 	const svm_problem *prob, const svm_parameter *param,
-	double Cp, double Cn)
+	double Cp, double Cn, int dense_dim, const shared_kernel *shared)
 {
 	double *alpha = Malloc(double,prob->l);
 	Solver::SolutionInfo si;
 	switch(param->svm_type)
 	{
 		case C_SVC:
-			solve_c_svc(prob,param,alpha,&si,Cp,Cn);
+			solve_c_svc(prob,param,alpha,&si,Cp,Cn,dense_dim,shared);
 			break;
 		case NU_SVC:
-			solve_nu_svc(prob,param,alpha,&si);
+			solve_nu_svc(prob,param,alpha,&si,dense_dim,shared);
 			break;
 		case ONE_CLASS:
-			solve_one_class(prob,param,alpha,&si);
+			solve_one_class(prob,param,alpha,&si,dense_dim);
 			break;
 		case EPSILON_SVR:
-			solve_epsilon_svr(prob,param,alpha,&si);
+			solve_epsilon_svr(prob,param,alpha,&si,dense_dim);
 			break;
 		case NU_SVR:
-			solve_nu_svr(prob,param,alpha,&si);
+			solve_nu_svr(prob,param,alpha,&si,dense_dim);
 			break;
 	}
 
@@ -1917,10 +2492,14 @@ static void multiclass_probability(int k, double **r, double *p)
 	free(Qp);
 }
 
-// Cross-validation decision values for probability estimates
+static svm_model *svm_train_samples(const svm_problem *prob, const svm_parameter *param,
+				     int dense_dim, CacheBudget *budget, bool report);
+
+// Cross-validation decision values for probability estimates; the models
+// trained for the folds take their kernel caches from budget
 static void svm_binary_svc_probability(
 	const svm_problem *prob, const svm_parameter *param,
-	double Cp, double Cn, double& probA, double& probB)
+	double Cp, double Cn, double& probA, double& probB, CacheBudget *budget)
 {
 	int i;
 	int nr_fold = 5;
@@ -1986,7 +2565,7 @@ static void svm_binary_svc_probability(
 			subparam.weight_label[1]=-1;
 			subparam.weight[0]=Cp;
 			subparam.weight[1]=Cn;
-			struct svm_model *submodel = svm_train(&subprob,&subparam);
+			struct svm_model *submodel = svm_train_samples(&subprob,&subparam,0,budget,false);
 			for(j=begin;j<end;j++)
 			{
 				svm_predict_values(submodel,prob->x[perm[j]],&(dec_values[perm[j]]));
@@ -2037,6 +2616,30 @@ static double svm_svr_probability(
 }
 
 
+// the classes i < j compared by the p-th of the nr_class*(nr_class-1)/2
+// one-vs-one subproblems
+static void svm_pair_classes(int nr_class, int p, int &i, int &j)
+{
+	int nr_trig = nr_class * (nr_class - 1) / 2;
+	i = nr_class - 0.5 * (1 + sqrt(8 * (nr_trig - p) + 1));
+	j = p - (2 * nr_class - i - 3) * i / 2 + 1;
+}
+
+struct pair_cost
+{
+	int p;
+	int l;
+};
+
+// larger subproblems first, otherwise in order
+static int compare_pair_cost(const void *a, const void *b)
+{
+	const pair_cost *x = (const pair_cost *)a, *y = (const pair_cost *)b;
+	if(x->l != y->l)
+		return x->l > y->l ? -1 : 1;
+	return x->p - y->p;
+}
+
 // label: label name, start: begin of each class, count: #data of classes, perm: indices to the original data
 // perm, length l, must be allocated before calling this subroutine
 static void svm_group_classes(const svm_problem *prob, int *nr_class_ret, int **label_ret, int **start_ret, int **count_ret, int *perm)
@@ -2117,7 +2720,11 @@ static void svm_group_classes(const svm_problem *prob, int *nr_class_ret, int **
 //
 // Interface functions
 //
-svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
+// the kernel caches of classification problems share budget, or a budget of
+// their own of cache_size if it is NULL; only the trainings requested by the
+// caller report their subproblems, not those nested for probability estimates
+static svm_model *svm_train_samples(const svm_problem *prob, const svm_parameter *param,
+				     int dense_dim, CacheBudget *budget, bool report)
 {
 	svm_model *model = Malloc(svm_model,1);
 	model->param = *param;
@@ -2142,7 +2749,7 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			model->probA[0] = svm_svr_probability(prob,param);
 		}
 
-		decision_function f = svm_train_one(prob,param,0,0);
+		decision_function f = svm_train_one(prob,param,0,0,dense_dim,NULL);
 		model->rho = Malloc(double,1);
 		model->rho[0] = f.rho;
 
@@ -2217,10 +2824,45 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			probB=Malloc(double,nr_trig);
 		}
 
-#pragma omp parallel for schedule(guided)
-		for (int p = 0; p < nr_trig; ++p) {
-			int i = nr_class - 0.5 * (1 + sqrt(8 * (nr_trig - p) + 1));
-			int j = p - (2 * nr_class - i - 3) * i / 2 + 1;
+		// with more than two classes, each class takes part in several
+		// subproblems, which share the kernel values within the classes;
+		// all their caches, including those of the models trained for
+		// probability estimates, share a budget of cache_size
+		CacheBudget own_budget((long int)(param->cache_size*(1<<20)));
+		if(!budget)
+			budget = &own_budget;
+		ClassCache *class_cache = NULL;
+		if(nr_class > 2)
+		{
+			class_cache = new ClassCache(l,x,nr_class,start,count,budget);
+			with_training_kernel(*param, dense_dim, [&](auto kernel, auto samples) {
+				typedef typename decltype(samples)::type S;
+				class_cache->compute_diagonal(kernel, S(x,dense_dim),
+							      param->kernel_type == RBF);
+			});
+		}
+
+		// dispatch the subproblems one by one, largest first, such that
+		// no large subproblem is left to finish after all others
+		pair_cost *order = Malloc(pair_cost,nr_trig);
+		for(int p=0;p<nr_trig;p++)
+		{
+			int i, j;
+			svm_pair_classes(nr_class,p,i,j);
+			order[p].p = p;
+			order[p].l = count[i]+count[j];
+		}
+		qsort(order,nr_trig,sizeof(pair_cost),compare_pair_cost);
+		double train_start = wall_time();
+
+		// a single subproblem (binary classification) rather parallelizes
+		// the computation of its kernel columns
+#pragma omp parallel for schedule(dynamic,1) if(nr_trig > 1)
+		for (int q = 0; q < nr_trig; ++q) {
+			int p = order[q].p;
+			int i, j;
+			svm_pair_classes(nr_class,p,i,j);
+			double pair_start = wall_time();
 
 			svm_problem sub_prob;
 			int si = start[i], sj = start[j];
@@ -2228,22 +2870,28 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			sub_prob.l = ci+cj;
 			sub_prob.x = Malloc(svm_node *,sub_prob.l);
 			sub_prob.y = Malloc(double,sub_prob.l);
+			int *sub_index = Malloc(int,sub_prob.l);
 			int k;
 			for(k=0;k<ci;k++)
 			{
 				sub_prob.x[k] = x[si+k];
 				sub_prob.y[k] = +1;
+				sub_index[k] = si+k;
 			}
 			for(k=0;k<cj;k++)
 			{
 				sub_prob.x[ci+k] = x[sj+k];
 				sub_prob.y[ci+k] = -1;
+				sub_index[ci+k] = sj+k;
 			}
 
 			if(param->probability)
-				svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],probA[p],probB[p]);
+				svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],
+							   probA[p],probB[p],budget);
 
-			f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
+			shared_kernel shared = {class_cache, sub_index, budget};
+			f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j],dense_dim,
+					     &shared);
 			for(k=0;k<ci;k++)
 				if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
 					nonzero[si+k] = true;
@@ -2252,7 +2900,18 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 					nonzero[sj+k] = true;
 			free(sub_prob.x);
 			free(sub_prob.y);
+			free(sub_index);
+
+			if(report && svm_train_report)
+			{
+				double pair_end = wall_time();
+#pragma omp critical(svm_train_report)
+				(*svm_train_report)(label[i],label[j],ci+cj,
+						    pair_start-train_start,pair_end-train_start);
+			}
 		}
+		delete class_cache;
+		free(order);
 
 		// build output
 
@@ -2321,8 +2980,8 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 
 #pragma omp parallel for schedule(guided)
 		for (int p = 0; p < nr_trig; ++p) {
-			int i = nr_class - 0.5 * (1 + sqrt(8 * (nr_trig - p) + 1));
-			int j = p - (2 * nr_class - i - 3) * i / 2 + 1;
+			int i, j;
+			svm_pair_classes(nr_class,p,i,j);
 
 			// classifier (i,j): coefficients with
 			// i are in sv_coef[j-1][nz_start[i]...],
@@ -2359,6 +3018,55 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 	return model;
 }
 
+svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
+{
+	return svm_train_samples(prob,param,0,NULL,true);
+}
+
+svm_model *svm_train_dense(const svm_dense_problem *prob, const svm_parameter *param)
+{
+	// the solvers only ever permute the pointers to the training vectors, so
+	// they are handed the rows of the matrix in place of svm_node arrays
+	int l = prob->l;
+	int dim = prob->dim;
+	svm_problem rows;
+	rows.l = l;
+	rows.y = prob->y;
+	rows.x = Malloc(svm_node *,l);
+	for(int i=0;i<l;i++)
+		rows.x[i] = (svm_node *)(prob->x + (size_t)i*dim);
+	svm_model *model = svm_train_samples(&rows,param,dim,NULL,true);
+	free(rows.x);
+
+	// store the SVs as svm_node arrays in a single block
+	size_t nnz = 0;
+	for(int i=0;i<model->l;i++)
+	{
+		const double *sv = (const double *)model->SV[i];
+		for(int k=0;k<dim;k++)
+			if(sv[k] != 0)
+				++nnz;
+	}
+	svm_node *node = Malloc(svm_node,nnz+model->l);
+	for(int i=0;i<model->l;i++)
+	{
+		const double *sv = (const double *)model->SV[i];
+		model->SV[i] = node;
+		for(int k=0;k<dim;k++)
+			if(sv[k] != 0)
+			{
+				node->index = k+1;
+				node->value = sv[k];
+				++node;
+			}
+		node->index = -1;
+		node->value = 0;
+		++node;
+	}
+	model->free_sv = 1;
+	return model;
+}
+
 // Stratified cross validation
 void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, int nr_fold, double *target)
 {
@@ -2522,7 +3230,43 @@ double svm_get_svr_probability(const svm_model *model)
 	}
 }
 
-double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
+double svm_predict_decision_values(const svm_model *model, const double *dec_values, svm_workspace *ws)
+{
+	int i;
+	if(model->param.svm_type == ONE_CLASS)
+		return (dec_values[0]>0)?1:-1;
+	else if(model->param.svm_type == EPSILON_SVR ||
+		model->param.svm_type == NU_SVR)
+		return dec_values[0];
+	else
+	{
+		int nr_class = model->nr_class;
+
+		int *vote = ws->vote;
+		for(i=0;i<nr_class;i++)
+			vote[i] = 0;
+
+		int p=0;
+		for(i=0;i<nr_class;i++)
+			for(int j=i+1;j<nr_class;j++)
+			{
+				if(dec_values[p] > 0)
+					++vote[i];
+				else
+					++vote[j];
+				p++;
+			}
+
+		int vote_max_idx = 0;
+		for(i=1;i<nr_class;i++)
+			if(vote[i] > vote[vote_max_idx])
+				vote_max_idx = i;
+
+		return model->label[vote_max_idx];
+	}
+}
+
+double svm_predict_kernel_values(const svm_model *model, const double *kvalue, double* dec_values, svm_workspace *ws)
 {
 	int i;
 	if(model->param.svm_type == ONE_CLASS ||
@@ -2532,33 +3276,19 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 		double *sv_coef = model->sv_coef[0];
 		double sum = 0;
 		for(i=0;i<model->l;i++)
-			sum += sv_coef[i] * Kernel::k_function(x,model->SV[i],model->param);
+			sum += sv_coef[i] * kvalue[i];
 		sum -= model->rho[0];
 		*dec_values = sum;
-
-		if(model->param.svm_type == ONE_CLASS)
-			return (sum>0)?1:-1;
-		else
-			return sum;
 	}
 	else
 	{
 		int nr_class = model->nr_class;
-		int l = model->l;
-		
-		double *kvalue = Malloc(double,l);
-		for(i=0;i<l;i++)
-			kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
 
-		int *start = Malloc(int,nr_class);
+		int *start = ws->start;
 		start[0] = 0;
 		for(i=1;i<nr_class;i++)
 			start[i] = start[i-1]+model->nSV[i-1];
 
-		int *vote = Malloc(int,nr_class);
-		for(i=0;i<nr_class;i++)
-			vote[i] = 0;
-
 		int p=0;
 		for(i=0;i<nr_class;i++)
 			for(int j=i+1;j<nr_class;j++)
@@ -2578,24 +3308,61 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 					sum += coef2[sj+k] * kvalue[sj+k];
 				sum -= model->rho[p];
 				dec_values[p] = sum;
-
-				if(dec_values[p] > 0)
-					++vote[i];
-				else
-					++vote[j];
 				p++;
 			}
+	}
+	return svm_predict_decision_values(model, dec_values, ws);
+}
 
-		int vote_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(vote[i] > vote[vote_max_idx])
-				vote_max_idx = i;
+void svm_kernel_values(const svm_model *model, const svm_node *x, int begin, int end, double *kvalue)
+{
+	with_kernel_function(model->param, [&](const auto& kernel) {
+		for(int i=begin;i<end;i++)
+			kvalue[i] = kernel(x,model->SV[i]);
+	});
+}
 
-		free(kvalue);
-		free(start);
-		free(vote);
-		return model->label[vote_max_idx];
-	}
+double svm_predict_values_workspace(const svm_model *model, const svm_node *x, double* dec_values, svm_workspace *ws)
+{
+	svm_kernel_values(model, x, 0, model->l, ws->kvalue);
+	return svm_predict_kernel_values(model, ws->kvalue, dec_values, ws);
+}
+
+void svm_kernel_values_dense(const svm_model *model, const double *x, int dim, int begin, int end, double *kvalue)
+{
+	with_kernel_function(model->param, [&](const auto& kernel) {
+		for(int i=begin;i<end;i++)
+			kvalue[i] = kernel(x,dim,model->SV[i]);
+	});
+}
+
+double svm_predict_values_dense(const svm_model *model, const double *x, int dim, double* dec_values)
+{
+	int nr_class = model->nr_class;
+	svm_workspace ws;
+	ws.kvalue = Malloc(double,model->l);
+	ws.start = Malloc(int,nr_class);
+	ws.vote = Malloc(int,nr_class);
+	svm_kernel_values_dense(model, x, dim, 0, model->l, ws.kvalue);
+	double pred_result = svm_predict_kernel_values(model, ws.kvalue, dec_values, &ws);
+	free(ws.kvalue);
+	free(ws.start);
+	free(ws.vote);
+	return pred_result;
+}
+
+double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
+{
+	int nr_class = model->nr_class;
+	svm_workspace ws;
+	ws.kvalue = Malloc(double,model->l);
+	ws.start = Malloc(int,nr_class);
+	ws.vote = Malloc(int,nr_class);
+	double pred_result = svm_predict_values_workspace(model, x, dec_values, &ws);
+	free(ws.kvalue);
+	free(ws.start);
+	free(ws.vote);
+	return pred_result;
 }
 
 double svm_predict(const svm_model *model, const svm_node *x)
@@ -3188,6 +3955,20 @@ const char *svm_check_parameter(const svm_problem *prob, const svm_parameter *pa
 	return NULL;
 }
 
+const char *svm_check_parameter_dense(const svm_dense_problem *prob, const svm_parameter *param)
+{
+	if(param->kernel_type == PRECOMPUTED)
+		return "precomputed kernel not supported for dense problems";
+	if(param->probability)
+		return "probability estimates not supported for dense problems";
+
+	svm_problem labels;	// only l and y are checked
+	labels.l = prob->l;
+	labels.y = prob->y;
+	labels.x = NULL;
+	return svm_check_parameter(&labels,param);
+}
+
 int svm_check_probability_model(const svm_model *model)
 {
 	return ((model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC) &&
@@ -3203,3 +3984,8 @@ void svm_set_print_string_function(void (*print_func)(const char *))
 	else
 		svm_print_string = print_func;
 }
+
+void svm_set_train_report_function(void (*report_func)(int, int, int, double, double))
+{
+	svm_train_report = report_func;
+}
@@ -0,0 +1,226 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "hyperplane_model.hpp"
+#include "model_test.hpp"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/linear_precomputed.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+// count heap allocations by interposing malloc, which is also what
+// operator new and the libsvm code end up calling
+#ifdef __GLIBC__
+extern "C" void * __libc_malloc (size_t);
+
+static size_t nr_allocs = 0;
+
+extern "C" void * malloc (size_t size) {
+    ++nr_allocs;
+    return __libc_malloc(size);
+}
+#endif
+
+template <class Model>
+void check_batch (Model const& model,
+                  std::vector<typename Model::input_container_type> const& xs)
+{
+    using label_t = typename Model::label_type;
+    using decision_t = typename Model::decision_type;
+    std::vector<label_t> labels(xs.size());
+    std::vector<decision_t> decisions(xs.size());
+    model.predict_batch(xs.begin(), xs.end(), labels.begin(), decisions.begin());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto res = model(xs[i]);
+        CHECK(labels[i] == res.first);
+        CHECK(decisions[i] == res.second);
+    }
+}
+
+template <class Kernel>
+void batch_binary_test (size_t N, size_t M) {
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(N, rng);
+    svm::model<Kernel> model(
+        fill_problem<svm::problem<Kernel>>(M, rng, trial_model),
+        svm::parameters<Kernel> {});
+
+    using input_t = typename svm::model<Kernel>::input_container_type;
+    std::uniform_real_distribution<double> uniform;
+    std::vector<input_t> xs;
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(std::move(x));
+    }
+    check_batch(model, xs);
+}
+
+TEST_CASE("batch-binary-builtin") {
+    batch_binary_test<svm::kernel::linear>(5, 1000);
+}
+
+TEST_CASE("batch-binary-precomputed") {
+    batch_binary_test<svm::kernel::linear_precomputed>(5, 500);
+}
+
+TEST_CASE("batch-multi-class") {
+    using cmplx = std::complex<double>;
+    using kernel_t = svm::kernel::rbf;
+    using problem_t = svm::problem<kernel_t>;
+    using model_t = svm::model<kernel_t>;
+    using C = typename problem_t::input_container_type;
+
+    const size_t M = 1000;
+    const size_t N = 5;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    problem_t batch(2);
+    auto prob = sector_problem<problem_t>(M, N, rng);
+    model_t model(std::move(prob), svm::parameters<kernel_t> {});
+    CHECK(model.nr_labels() == N);
+
+    std::vector<C> xs;
+    for (size_t i = 0; i < M; ++i) {
+        cmplx c {uniform(rng), uniform(rng)};
+        xs.push_back(C {c.real(), c.imag()});
+        batch.add_sample(C {c.real(), c.imag()}, 0.);
+    }
+    check_batch(model, xs);
+
+    std::vector<double> labels(M);
+    std::vector<model_t::decision_type> decisions(M);
+    model.predict_batch(batch, labels.begin(), decisions.begin());
+    for (size_t i = 0; i < M; ++i) {
+        auto res = model(xs[i]);
+        CHECK(labels[i] == res.first);
+        CHECK(decisions[i] == res.second);
+    }
+}
+
+TEST_CASE("batch-views") {
+    using kernel_t = svm::kernel::rbf;
+    using model_t = svm::model<kernel_t>;
+
+    const size_t M = 200;
+    const size_t N = 4;
+
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(N, rng);
+    model_t model(fill_problem<svm::problem<kernel_t>>(M, rng, trial_model),
+                  svm::parameters<kernel_t> {});
+
+    std::uniform_real_distribution<double> uniform;
+    std::vector<double> buffer(M * N);
+    for (double & x : buffer)
+        x = uniform(rng);
+    std::vector<svm::dataset> xs;
+    std::vector<svm::dense_view> views;
+    for (size_t i = 0; i < M; ++i) {
+        xs.emplace_back(std::vector<double>(&buffer[i * N], &buffer[(i + 1) * N]));
+        views.emplace_back(&buffer[i * N], N);
+    }
+
+    auto check_views = [&] {
+        std::vector<double> labels(M);
+        std::vector<model_t::decision_type> decisions(M);
+        model.predict_batch(views.begin(), views.end(),
+                            labels.begin(), decisions.begin());
+        for (size_t i = 0; i < M; ++i) {
+            auto res = model(xs[i]);
+            auto res_sparse = model(svm::data_view(xs[i]));
+            auto res_dense = model(views[i]);
+            CHECK(res_sparse.first == res.first);
+            CHECK(res_sparse.second == res.second);
+            CHECK(res_dense.first == res.first);
+            CHECK(labels[i] == res.first);
+            for (size_t p = 0; p < res.second.size(); ++p) {
+                CHECK(res_dense.second[p] == doctest::Approx(res.second[p]));
+                CHECK(decisions[i][p] == doctest::Approx(res.second[p]));
+            }
+        }
+    };
+
+    check_views();
+    model.compile();
+    check_views();
+}
+
+// the samples of a sparse batch are passed on as views into its CSR arena
+// rather than being copied, so the allocations (for the workspaces) do not
+// grow with the size of the batch
+TEST_CASE("batch-sparse-allocations") {
+    using kernel_t = svm::kernel::rbf;
+    using problem_t = svm::problem<kernel_t>;
+    using model_t = svm::model<kernel_t>;
+    using C = typename problem_t::input_container_type;
+
+    const size_t M = 1000;
+    const size_t N = 5;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    model_t model(sector_problem<problem_t>(M, N, rng),
+                  svm::parameters<kernel_t> {});
+
+    problem_t small_batch(2), large_batch(2);
+    for (size_t i = 0; i < 2 * M; ++i) {
+        C x {uniform(rng), uniform(rng)};
+        if (i < M)
+            small_batch.add_sample(x, 0.);
+        large_batch.add_sample(x, 0.);
+    }
+
+    auto check_allocs = [&] {
+        std::vector<double> labels(2 * M);
+        std::vector<model_t::decision_type> decisions(2 * M);
+        // size the decisions
+        model.predict_batch(large_batch, labels.begin(), decisions.begin());
+#ifdef __GLIBC__
+        size_t allocs_before = nr_allocs;
+        model.predict_batch(small_batch, labels.begin(), decisions.begin());
+        size_t small_allocs = nr_allocs - allocs_before;
+        allocs_before = nr_allocs;
+        model.predict_batch(large_batch, labels.begin(), decisions.begin());
+        size_t large_allocs = nr_allocs - allocs_before;
+        CHECK(small_allocs < M);
+        CHECK(large_allocs == small_allocs);
+#endif
+    };
+
+    check_allocs();
+    model.compile();
+    check_allocs();
+}
@@ -0,0 +1,96 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <svm/batch_scheduler.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+TEST_CASE("batch-scheduler") {
+    using kernel_t = svm::kernel::rbf;
+    using model_t = svm::model<kernel_t>;
+    using C = model_t::input_container_type;
+
+    const size_t M = 1000;
+    const size_t N = 4;
+    const size_t T = 4;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    auto prob = sector_problem<model_t::problem_t>(M, N, rng);
+    model_t model(std::move(prob), svm::parameters<kernel_t> {});
+
+    std::vector<C> xs;
+    for (size_t i = 0; i < M; ++i)
+        xs.push_back(C {uniform(rng), uniform(rng)});
+
+    auto check = [&] (model_t const& model, size_t nr_workers, size_t max_batch) {
+        std::vector<std::future<std::pair<double, std::vector<double>>>> futures(M);
+        {
+            svm::batch_scheduler<model_t> scheduler(model, nr_workers,
+                                                    std::chrono::microseconds(500),
+                                                    max_batch);
+            std::vector<std::thread> clients;
+            for (size_t t = 0; t < T; ++t)
+                clients.emplace_back([&, t] {
+                    for (size_t i = t; i < M; i += T)
+                        futures[i] = scheduler.submit(xs[i]);
+                });
+            for (auto & c : clients)
+                c.join();
+        }
+        size_t mismatches = 0;
+        for (size_t i = 0; i < M; ++i) {
+            auto res = futures[i].get();
+            auto expected = model(xs[i]);
+            if (res.first != expected.first)
+                ++mismatches;
+            for (size_t k = 0; k < expected.second.size(); ++k)
+                if (std::abs(res.second[k] - expected.second[k]) > 1e-10)
+                    ++mismatches;
+        }
+        CHECK(mismatches == 0);
+    };
+
+    SUBCASE("sparse") {
+        check(model, 2, 16);
+    }
+    SUBCASE("compiled") {
+        model.compile();
+        check(model, 3, 64);
+    }
+    SUBCASE("single-request-batches") {
+        check(model, 1, 1);
+    }
+}
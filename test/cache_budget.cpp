@@ -0,0 +1,118 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+
+#include <svm/dataset.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// track the peak of the heap in use by interposing the allocation functions,
+// which the kernel caches call directly
+#ifdef __GLIBC__
+#include <malloc.h>
+
+extern "C" void * __libc_malloc (size_t);
+extern "C" void * __libc_calloc (size_t, size_t);
+extern "C" void * __libc_realloc (void *, size_t);
+extern "C" void __libc_free (void *);
+
+static std::atomic<long> heap_in_use(0), heap_peak(0);
+
+static void heap_grew (long bytes) {
+    long now = heap_in_use += bytes;
+    long peak = heap_peak;
+    while (now > peak && !heap_peak.compare_exchange_weak(peak, now));
+}
+
+extern "C" void * malloc (size_t size) {
+    void * p = __libc_malloc(size);
+    if (p)
+        heap_grew(malloc_usable_size(p));
+    return p;
+}
+
+extern "C" void * calloc (size_t n, size_t size) {
+    void * p = __libc_calloc(n, size);
+    if (p)
+        heap_grew(malloc_usable_size(p));
+    return p;
+}
+
+extern "C" void * realloc (void * old, size_t size) {
+    long old_size = old ? malloc_usable_size(old) : 0;
+    void * p = __libc_realloc(old, size);
+    if (p)
+        heap_grew(long(malloc_usable_size(p)) - old_size);
+    return p;
+}
+
+extern "C" void free (void * p) {
+    if (p)
+        heap_in_use -= malloc_usable_size(p);
+    __libc_free(p);
+}
+
+TEST_CASE("cache-budget-probability") {
+    using kernel_t = svm::kernel::rbf;
+    using model_t = svm::model<kernel_t>;
+
+    const size_t M = 2000;
+    const size_t N = 4;
+    const long budget = 2 << 20;
+
+    // random labels: almost all samples become support vectors and the
+    // solvers need most of the kernel matrix
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::uniform_int_distribution<int> random_label(0, N - 1);
+    model_t::problem_t prob(2);
+    for (size_t i = 0; i < M; ++i)
+        prob.add_sample(svm::dataset {uniform(rng), uniform(rng)}, random_label(rng));
+    svm::parameters<kernel_t> params(1., svm::machine_type::C_SVC);
+    params.cache_size() = double(budget) / (1 << 20);
+    params.svm_params_ptr()->probability = 1;
+
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+    long before = heap_in_use;
+    heap_peak = before;
+    model_t model(std::move(prob), params);
+    long peak = heap_peak - before;
+
+    // the caches of the pair solvers and of the cross-validation models for
+    // the probability estimates, trained concurrently, stay within a single
+    // cache_size, and so does everything else allocated while training
+    CHECK(peak < budget);
+    CHECK(model.nr_labels() == N);
+}
+#endif
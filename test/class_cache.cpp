@@ -0,0 +1,87 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+// the one-vs-one subproblems take the kernel rows within each class from a
+// shared cache; still, each classifier of a multi-class model agrees with the
+// binary model trained on the samples of its two classes alone
+void class_cache_test (svm::parameters<svm::kernel::rbf> const& params,
+                             double epsilon) {
+    using model_t = svm::model<svm::kernel::rbf>;
+    using C = typename model_t::input_container_type;
+
+    const size_t M = 400;
+    const size_t N = 4;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    std::vector<std::pair<C, double>> samples;
+    model_t::problem_t prob(2);
+    for (size_t i = 0; i < M; ++i) {
+        double x = uniform(rng);
+        double y = uniform(rng);
+        samples.emplace_back(C {x, y}, sector_label(x, y, N));
+        prob.add_sample(samples.back().first, samples.back().second);
+    }
+    model_t model(std::move(prob), params);
+    auto const classifiers = model.classifiers();
+    REQUIRE(classifiers.size() == N * (N - 1) / 2);
+
+    for (auto const& classifier : classifiers) {
+        auto labels = classifier.labels();
+        model_t::problem_t sub_prob(2);
+        for (double l : {labels.first, labels.second})
+            for (auto const& s : samples)
+                if (s.second == l)
+                    sub_prob.add_sample(s.first, s.second);
+        model_t binary(std::move(sub_prob), params);
+        REQUIRE(binary.classifiers()[0].labels() == labels);
+
+        for (size_t i = 0; i < 20; ++i) {
+            C x {uniform(rng), uniform(rng)};
+            CHECK(classifier.pairwise(x).second
+                  == doctest::Approx(binary.classifiers()[0](x).second)
+                     .epsilon(epsilon));
+        }
+    }
+}
+
+// the binary nu-SVC solution only agrees up to the solver's tolerance
+TEST_CASE("class-cache-nu-svc") {
+    class_cache_test(svm::parameters<svm::kernel::rbf> {}, 1e-2);
+}
+
+TEST_CASE("class-cache-c-svc") {
+    class_cache_test(svm::parameters<svm::kernel::rbf>(1., svm::machine_type::C_SVC),
+                     1e-5);
+}
@@ -0,0 +1,147 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "hyperplane_model.hpp"
+#include "model_test.hpp"
+#include "sector_problem.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear_precomputed.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/serialization/ascii.hpp>
+#include <svm/serialization/serializer.hpp>
+
+
+// peeks at what a trained model keeps alive
+struct inspect_tag {};
+
+namespace svm {
+namespace serialization {
+
+    template <class Model>
+    struct model_serializer<inspect_tag, Model> {
+        model_serializer (Model const& m) : model_(m) {}
+
+        bool owns_support_vectors () const { return model_.m->free_sv; }
+        size_t nr_samples () const { return model_.prob.size(); }
+        size_t nr_support_vectors () const { return model_.m->l; }
+        struct svm_node const * support_vector (size_t i) const {
+            return model_.m->SV[i];
+        }
+
+    private:
+        Model const& model_;
+    };
+
+}
+}
+
+template <class Model, class Input>
+void check_round_trip (Model & model, std::vector<Input> const& xs,
+                       std::string const& name)
+{
+    svm::serialization::model_serializer<svm::ascii_tag, Model> saver(model);
+    saver.save(name);
+
+    Model restored;
+    svm::serialization::model_serializer<svm::ascii_tag, Model> loader(restored);
+    loader.load(name);
+
+    CHECK(restored.nSV() == model.nSV());
+    for (Input const& x : xs) {
+        auto expected = model(x);
+        auto res = restored(x);
+        CHECK(res.first == expected.first);
+        for (size_t k = 0; k < expected.second.size(); ++k)
+            CHECK(res.second[k] == doctest::Approx(expected.second[k]));
+    }
+}
+
+TEST_CASE("compact-builtin") {
+    using kernel_t = svm::kernel::rbf;
+    using model_t = svm::model<kernel_t>;
+    using C = model_t::input_container_type;
+
+    const size_t M = 1000;
+    const size_t N = 3;
+
+    std::mt19937 rng(42);
+    model_t model(sector_problem<model_t::problem_t>(M, N, rng),
+                  svm::parameters<kernel_t> {});
+
+    svm::serialization::model_serializer<inspect_tag, model_t> inspect(model);
+    size_t nr_sv = inspect.nr_support_vectors();
+    REQUIRE(nr_sv > 0);
+    CHECK(nr_sv < M);
+    CHECK(inspect.owns_support_vectors());
+    // the training samples are released...
+    CHECK(inspect.nr_samples() == 0);
+    // ...and the support vectors copied back to back into a single block
+    for (size_t i = 1; i < nr_sv; ++i) {
+        struct svm_node const * prev = inspect.support_vector(i - 1);
+        while (prev->index != -1)
+            ++prev;
+        CHECK(inspect.support_vector(i) == prev + 1);
+    }
+
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<C> xs;
+    for (size_t i = 0; i < 100; ++i)
+        xs.push_back(C {uniform(rng), uniform(rng)});
+    check_round_trip(model, xs, "compact-builtin-model");
+}
+
+TEST_CASE("compact-precomputed") {
+    using kernel_t = svm::kernel::linear_precomputed;
+    using model_t = svm::model<kernel_t>;
+    using C = model_t::input_container_type;
+
+    const size_t M = 500;
+
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(5, rng);
+    model_t model(fill_problem<model_t::problem_t>(M, rng, trial_model),
+                  svm::parameters<kernel_t>(0.1));
+
+    // only the samples which became support vectors are retained
+    svm::serialization::model_serializer<inspect_tag, model_t> inspect(model);
+    size_t nr_sv = inspect.nr_support_vectors();
+    REQUIRE(nr_sv > 0);
+    CHECK(nr_sv < M);
+    CHECK(inspect.owns_support_vectors());
+    CHECK(inspect.nr_samples() == nr_sv);
+
+    std::uniform_real_distribution<double> uniform;
+    std::vector<C> xs;
+    for (size_t i = 0; i < 100; ++i) {
+        C x(trial_model.dim());
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.push_back(std::move(x));
+    }
+    check_round_trip(model, xs, "compact-precomputed-model");
+}
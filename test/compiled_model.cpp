@@ -0,0 +1,205 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "circle_model.hpp"
+#include "model_test.hpp"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <svm/dataset.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/polynomial.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/kernel/sigmoid.hpp>
+
+
+template <class Kernel>
+void compiled_test (size_t M, double nu) {
+    std::mt19937 rng(42);
+    circle_model trial_model({0.5, 0.5, 0.5, 0.5}, 0.5);
+    svm::parameters<Kernel> params(nu);
+    svm::model<Kernel> model(
+        fill_problem<svm::problem<Kernel>>(M, rng, trial_model),
+        params);
+
+    std::uniform_real_distribution<double> uniform;
+    std::vector<svm::dataset> xs;
+    std::vector<std::pair<double, double>> expected;
+    auto classifier = model.classifier();
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(trial_model.dim());
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(x);
+        expected.push_back(classifier(xs.back()));
+    }
+
+    CHECK(!model.compiled());
+    model.compile();
+    CHECK(model.compiled());
+
+    auto ws = model.workspace();
+    for (size_t m = 0; m < M; ++m) {
+        auto res = classifier(xs[m]);
+        auto res_ws = model(xs[m], ws);
+        CHECK(res.second == doctest::Approx(expected[m].second));
+        CHECK(res_ws.second[0] == doctest::Approx(expected[m].second));
+        if (std::abs(expected[m].second) > 1e-8) {
+            CHECK(res.first == expected[m].first);
+            CHECK(res_ws.first == expected[m].first);
+        }
+    }
+}
+
+TEST_CASE("compiled-linear") {
+    compiled_test<svm::kernel::linear>(1000, 0.2);
+}
+
+TEST_CASE("compiled-poly") {
+    compiled_test<svm::kernel::polynomial<2>>(1000, 0.2);
+    compiled_test<svm::kernel::polynomial<3>>(1000, 0.2);
+}
+
+TEST_CASE("compiled-rbf") {
+    compiled_test<svm::kernel::rbf>(1000, 0.1);
+}
+
+TEST_CASE("compiled-sigmoid") {
+    compiled_test<svm::kernel::sigmoid>(1000, 0.45);
+}
+
+TEST_CASE("linear-weights") {
+    // polynomial<1> with gamma = 1 and coef0 = 0 coincides with the linear
+    // kernel but does not collapse the support vectors into weight vectors
+    using linear_model_t = svm::model<svm::kernel::linear>;
+    using poly_model_t = svm::model<svm::kernel::polynomial<1>>;
+
+    const size_t M = 1000;
+    const size_t N = 5;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    linear_model_t::problem_t linear_prob(2);
+    poly_model_t::problem_t poly_prob(2);
+    for (size_t i = 0; i < M; ++i) {
+        double x = uniform(rng);
+        double y = uniform(rng);
+        double l = sector_label(x, y, N);
+        linear_prob.add_sample(svm::dataset {x, y}, l);
+        poly_prob.add_sample(svm::dataset {x, y}, l);
+    }
+    linear_model_t linear_model(std::move(linear_prob),
+                                svm::parameters<svm::kernel::linear> {});
+    poly_model_t poly_model(std::move(poly_prob),
+                            svm::parameters<svm::kernel::polynomial<1>> {});
+
+    for (size_t i = 0; i < M; ++i) {
+        svm::dataset x {uniform(rng), uniform(rng)};
+        auto res_linear = linear_model(x);
+        auto res_poly = poly_model(x);
+        for (size_t k = 0; k < res_poly.second.size(); ++k)
+            CHECK(res_linear.second[k] == doctest::Approx(res_poly.second[k]));
+    }
+}
+
+TEST_CASE("poly2-quadratic-form") {
+    using kernel_t = svm::kernel::polynomial<2>;
+    std::mt19937 rng(42);
+    circle_model trial_model({0.5, 0.5, 0.5, 0.5}, 0.5);
+    svm::parameters<kernel_t> params(0.2);
+    params.coef0() = 0.5;
+    svm::model<kernel_t> model(
+        fill_problem<svm::problem<kernel_t>>(1000, rng, trial_model),
+        params);
+
+    std::uniform_real_distribution<double> uniform;
+    std::vector<svm::dataset> xs;
+    std::vector<std::pair<double, double>> expected;
+    auto classifier = model.classifier();
+    for (size_t m = 0; m < 1000; ++m) {
+        std::vector<double> x(trial_model.dim());
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(x);
+        expected.push_back(classifier(xs.back()));
+    }
+
+    model.compile_quadratic_form();
+    CHECK(model.compiled());
+    for (size_t m = 0; m < xs.size(); ++m) {
+        auto res = classifier(xs[m]);
+        CHECK(res.second == doctest::Approx(expected[m].second));
+        if (std::abs(expected[m].second) > 1e-8)
+            CHECK(res.first == expected[m].first);
+    }
+}
+
+template <class Kernel>
+void compiled_batch_test (size_t N, double nu) {
+    using model_t = svm::model<Kernel>;
+
+    const size_t M = 1000;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    typename model_t::problem_t prob(2);
+    for (size_t i = 0; i < M; ++i) {
+        double x = uniform(rng);
+        double y = uniform(rng);
+        prob.add_sample(svm::dataset {x, y}, sector_label(x, y, N));
+    }
+    model_t model(std::move(prob), svm::parameters<Kernel> {nu});
+
+    std::vector<svm::dataset> xs;
+    for (size_t i = 0; i < M + 17; ++i)
+        xs.push_back(svm::dataset {uniform(rng), uniform(rng)});
+
+    model.compile();
+    std::vector<double> labels(xs.size());
+    std::vector<typename model_t::decision_type> decisions(xs.size());
+    model.predict_batch(xs.begin(), xs.end(), labels.begin(), decisions.begin());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto res = model(xs[i]);
+        CHECK(decisions[i].size() == res.second.size());
+        bool ambiguous = false;
+        for (size_t k = 0; k < res.second.size(); ++k) {
+            CHECK(decisions[i][k] == doctest::Approx(res.second[k]));
+            ambiguous |= std::abs(res.second[k]) < 1e-8;
+        }
+        if (!ambiguous)
+            CHECK(labels[i] == res.first);
+    }
+}
+
+TEST_CASE("compiled-batch") {
+    compiled_batch_test<svm::kernel::rbf>(5, 0.1);
+    compiled_batch_test<svm::kernel::polynomial<3>>(3, 0.3);
+    compiled_batch_test<svm::kernel::sigmoid>(2, 0.45);
+}
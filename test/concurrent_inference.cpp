@@ -0,0 +1,72 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+TEST_CASE("concurrent-inference") {
+    using kernel_t = svm::kernel::rbf;
+    using model_t = svm::model<kernel_t>;
+    using C = model_t::input_container_type;
+
+    const size_t M = 1000;
+    const size_t N = 4;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    auto prob = sector_problem<model_t::problem_t>(M, N, rng);
+    model_t const model(std::move(prob), svm::parameters<kernel_t> {});
+    auto const classifiers = model.classifiers();
+
+    std::vector<C> xs;
+    std::vector<std::pair<double, std::vector<double>>> expected;
+    for (size_t i = 0; i < M; ++i) {
+        xs.push_back(C {uniform(rng), uniform(rng)});
+        expected.push_back(model(xs.back()));
+    }
+
+    // all threads share the same model and classifier views
+    long mismatches = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:mismatches)
+    for (long i = 0; i < long(10 * M); ++i) {
+        size_t j = i % M;
+        auto res = model(xs[j]);
+        if (res != expected[j])
+            ++mismatches;
+        for (size_t c = 0; c < classifiers.size(); ++c)
+            if (classifiers[c](xs[j]).second != expected[j].second[c])
+                ++mismatches;
+        if (model.rho()[i % classifiers.size()] != classifiers[i % classifiers.size()].rho())
+            ++mismatches;
+    }
+    CHECK(mismatches == 0);
+}
@@ -21,6 +21,7 @@
 #include "doctest/doctest.h"
 
 #include <iostream>
+#include <numeric>
 #include <vector>
 
 #include <svm/dataset.hpp>
@@ -41,3 +42,48 @@ TEST_CASE("dataset-view") {
     test_data_view({3, 1, 4, 1, 5, 0, -9, 2});
     test_data_view({0, 1, 4, 1, 5, 0, -9, 2});
 }
+
+double dense_dot (std::vector<double> a, std::vector<double> b) {
+    a.resize(std::max(a.size(), b.size()));
+    b.resize(a.size());
+    return std::inner_product(a.begin(), a.end(), b.begin(), 0.);
+}
+
+TEST_CASE("data-view-dot") {
+    std::vector<std::vector<double>> vs {
+        {3, 1, 4, 1, 5, 9, 2, 6},
+        {2, 7, 1, 8},
+        {0, 1, 0, 0, 5, 0, -9, 2},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3},
+        {0, 0, 0},
+        {}
+    };
+    for (auto const& a : vs) {
+        svm::dataset da(a);
+        for (auto const& b : vs) {
+            svm::dataset db(b);
+            CHECK(svm::dot(da, db) == doctest::Approx(dense_dot(a, b)));
+            CHECK(svm::dot(da, b.data(), b.size()) == doctest::Approx(dense_dot(a, b)));
+        }
+    }
+    CHECK(svm::dot(svm::data_view(), svm::dataset(vs[0])) == 0.);
+}
+
+TEST_CASE("data-view-nonzeros") {
+    std::vector<double> a {0, 1, 0, 0, 5, 0, -9, 2, 0};
+    std::vector<std::pair<size_t, double>> expected {{1, 1.}, {4, 5.}, {6, -9.}, {7, 2.}};
+    svm::dataset d(a);
+    std::vector<std::pair<size_t, double>> nonzeros;
+    for (auto nz : d.nonzeros())
+        nonzeros.push_back(nz);
+    CHECK(nonzeros == expected);
+
+    svm::dataset d0(a, 0);
+    nonzeros.clear();
+    for (auto nz : d0.view().nonzeros())
+        nonzeros.push_back(nz);
+    CHECK(nonzeros == expected);
+
+    auto empty = svm::data_view().nonzeros();
+    CHECK(empty.begin() == empty.end());
+}
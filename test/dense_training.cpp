@@ -0,0 +1,224 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <svm/dataset.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/libsvm/svm.h>
+#include <svm/serialization/ascii.hpp>
+
+
+void dense_training_test (int kernel_type, int svm_type) {
+    const int N = 5;
+    const int M = 300;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    std::vector<double> matrix(N * M);
+    std::vector<double> y(M);
+    std::vector<svm::dataset> samples;
+    for (int m = 0; m < M; ++m) {
+        double * row = &matrix[N * m];
+        for (int k = 0; k < N; ++k)
+            row[k] = (k + m) % 3 ? uniform(rng) : 0.;
+        y[m] = svm_type == EPSILON_SVR ? row[0] - row[1]
+            : (row[0] * row[0] + row[1] > 0.3 ? 1 : (row[2] > 0 ? 2 : 3));
+        samples.emplace_back(row, row + N);
+    }
+
+    struct svm_parameter param = {};
+    param.svm_type = svm_type;
+    param.kernel_type = kernel_type;
+    param.degree = 3;
+    param.gamma = 1. / N;
+    param.coef0 = 0.5;
+    param.cache_size = 10;
+    param.eps = 1e-3;
+    param.C = 1;
+    param.nu = 0.3;
+    param.p = 0.1;
+    param.shrinking = 1;
+
+    std::vector<struct svm_node *> ptrs;
+    for (auto & s : samples)
+        ptrs.push_back(s.ptr());
+    struct svm_problem sparse_prob = {M, y.data(), ptrs.data()};
+    struct svm_dense_problem dense_prob = {M, N, y.data(), matrix.data()};
+    REQUIRE(svm_check_parameter(&sparse_prob, &param) == nullptr);
+    REQUIRE(svm_check_parameter_dense(&dense_prob, &param) == nullptr);
+
+    struct svm_model * sparse_model = svm_train(&sparse_prob, &param);
+    struct svm_model * dense_model = svm_train_dense(&dense_prob, &param);
+    REQUIRE(dense_model->l == sparse_model->l);
+    int nr_dec = svm_type == EPSILON_SVR ? 1
+        : sparse_model->nr_class * (sparse_model->nr_class - 1) / 2;
+    for (int p = 0; p < nr_dec; ++p)
+        CHECK(dense_model->rho[p] == doctest::Approx(sparse_model->rho[p]));
+    for (int i = 0; i < dense_model->l; ++i) {
+        CHECK(dense_model->sv_indices[i] == sparse_model->sv_indices[i]);
+        struct svm_node const * dense_sv = dense_model->SV[i];
+        struct svm_node const * sparse_sv = sparse_model->SV[i];
+        for (; sparse_sv->index != -1; ++dense_sv, ++sparse_sv) {
+            CHECK(dense_sv->index == sparse_sv->index);
+            CHECK(dense_sv->value == sparse_sv->value);
+        }
+        CHECK(dense_sv->index == -1);
+    }
+
+    std::vector<double> sparse_dec(nr_dec), dense_dec(nr_dec);
+    for (int m = 0; m < M; m += 7) {
+        double const * row = &matrix[N * m];
+        double label = svm_predict_values(sparse_model, ptrs[m], sparse_dec.data());
+        CHECK(svm_predict_values_dense(dense_model, row, N, dense_dec.data()) == label);
+        for (int p = 0; p < nr_dec; ++p)
+            CHECK(dense_dec[p] == doctest::Approx(sparse_dec[p]));
+    }
+
+    svm_free_and_destroy_model(&sparse_model);
+    svm_free_and_destroy_model(&dense_model);
+}
+
+TEST_CASE("dense-training-linear") {
+    dense_training_test(LINEAR, C_SVC);
+}
+
+TEST_CASE("dense-training-poly") {
+    dense_training_test(POLY, NU_SVC);
+}
+
+TEST_CASE("dense-training-rbf") {
+    dense_training_test(RBF, C_SVC);
+    dense_training_test(RBF, EPSILON_SVR);
+}
+
+TEST_CASE("dense-training-sigmoid") {
+    dense_training_test(SIGMOID, C_SVC);
+}
+
+TEST_CASE("dense-training-unsupported") {
+    double y = 1., x = 0.;
+    struct svm_dense_problem prob = {1, 1, &y, &x};
+    struct svm_parameter param = {};
+    param.kernel_type = PRECOMPUTED;
+    CHECK(svm_check_parameter_dense(&prob, &param) != nullptr);
+}
+
+// problems of dimension DENSE keep their samples as one matrix of the
+// dimension given at runtime and train on it through svm_train_dense; the
+// model evaluates against a dense copy of its support vectors
+template <class Kernel>
+void dense_problem_test () {
+    using sparse_model_t = svm::model<Kernel>;
+    using dense_model_t = svm::model<Kernel, double, svm::DENSE>;
+    static_assert(std::is_same<typename dense_model_t::input_container_type,
+                               svm::dense_dataset>::value, "");
+
+    const size_t N = 5;
+    const size_t M = 300;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    typename sparse_model_t::problem_t sparse_prob(N);
+    typename dense_model_t::problem_t dense_prob(N);
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        double y = x[0] * x[0] + x[1] > 0.3 ? 1 : (x[2] > 0 ? 2 : 3);
+        sparse_prob.add_sample(svm::dataset(x), y);
+        dense_prob.add_sample(svm::dense_dataset(x), y);
+    }
+    CHECK(dense_prob.view(7).first.data()
+          == dense_prob.view(6).first.data() + N);
+
+    svm::parameters<Kernel> params(1., svm::machine_type::C_SVC);
+    sparse_model_t sparse_model(std::move(sparse_prob), params);
+    dense_model_t dense_model(std::move(dense_prob), params);
+    CHECK(dense_model.dim() == N);
+    CHECK(dense_model.compiled() == (std::is_same<Kernel, svm::kernel::rbf>::value));
+    CHECK(dense_model.nSV() == sparse_model.nSV());
+
+    std::vector<svm::dense_dataset> xs;
+    typename dense_model_t::problem_t batch(N);
+    for (size_t m = 0; m < 100; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(x);
+        batch.add_sample(xs.back(), 0.);
+    }
+    std::vector<double> labels(xs.size());
+    std::vector<typename dense_model_t::decision_type> decisions(xs.size());
+    dense_model.predict_batch(batch, labels.begin(), decisions.begin());
+    auto ws = dense_model.workspace();
+    for (size_t m = 0; m < xs.size(); ++m) {
+        auto expected = sparse_model(svm::dataset(xs[m]));
+        auto res = dense_model(xs[m], ws);
+        bool ambiguous = false;
+        for (size_t p = 0; p < expected.second.size(); ++p) {
+            CHECK(res.second[p] == doctest::Approx(expected.second[p]));
+            CHECK(decisions[m][p] == doctest::Approx(expected.second[p]));
+            ambiguous |= std::abs(expected.second[p]) < 1e-8;
+        }
+        if (!ambiguous) {
+            CHECK(res.first == expected.first);
+            CHECK(labels[m] == expected.first);
+        }
+    }
+
+    svm::serialization::model_serializer<svm::ascii_tag, dense_model_t> saver(dense_model);
+    saver.save("dense-problem-model");
+    dense_model_t restored_model;
+    svm::serialization::model_serializer<svm::ascii_tag, dense_model_t> loader(restored_model);
+    loader.load("dense-problem-model");
+    CHECK(restored_model.dim() == N);
+    // libsvm stores rho and the support vectors with limited precision
+    for (size_t m = 0; m < xs.size(); m += 10)
+        for (size_t p = 0; p < 3; ++p)
+            CHECK(restored_model(xs[m]).second[p]
+                  == doctest::Approx(dense_model(xs[m]).second[p]).epsilon(1e-2));
+}
+
+TEST_CASE("dense-problem-linear") {
+    dense_problem_test<svm::kernel::linear>();
+}
+
+TEST_CASE("dense-problem-rbf") {
+    dense_problem_test<svm::kernel::rbf>();
+}
+
+TEST_CASE("dense-problem-mismatch") {
+    svm::problem<svm::kernel::rbf, double, svm::DENSE> prob(3);
+    CHECK_THROWS_AS(prob.add_sample(svm::dense_dataset {1., 2.}, 0.),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(prob.add_sample(svm::dense_dataset {1., 2., 3., 4.}, 0.),
+                    std::invalid_argument);
+    prob.add_sample(svm::dense_dataset {1., 2., 3.}, 0.);
+    CHECK(prob.size() == 1);
+}
@@ -0,0 +1,182 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "circle_model.hpp"
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <svm/dataset.hpp>
+#include <svm/fixed_dataset.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/polynomial.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/kernel/sigmoid.hpp>
+#include <svm/serialization/ascii.hpp>
+
+
+template <class Kernel>
+void fixed_dimension_test (size_t M, double nu) {
+    const size_t N = 4;
+    using dynamic_model_t = svm::model<Kernel>;
+    using fixed_model_t = svm::model<Kernel, double, N>;
+    static_assert(std::is_same<typename fixed_model_t::input_container_type,
+                               svm::fixed_dataset<N>>::value, "");
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform;
+    circle_model trial_model({0.5, 0.5, 0.5, 0.5}, 0.5);
+    typename dynamic_model_t::problem_t dynamic_prob(N);
+    typename fixed_model_t::problem_t fixed_prob(N);
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        double y = trial_model(x).first;
+        dynamic_prob.add_sample(svm::dataset(x), y);
+        fixed_prob.add_sample(svm::fixed_dataset<N>(x), y);
+    }
+    svm::parameters<Kernel> params(nu);
+    dynamic_model_t dynamic_model(std::move(dynamic_prob), params);
+    fixed_model_t fixed_model(std::move(fixed_prob), params);
+    CHECK(fixed_model.dim() == N);
+
+    std::vector<svm::fixed_dataset<N>> xs;
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(x);
+    }
+
+    std::vector<double> labels(M);
+    std::vector<std::vector<double>> decisions(M);
+    fixed_model.predict_batch(xs.begin(), xs.end(), labels.begin(), decisions.begin());
+    auto ws = fixed_model.workspace();
+    auto classifier = fixed_model.classifier();
+    auto dynamic_classifier = dynamic_model.classifier();
+    for (size_t m = 0; m < M; ++m) {
+        auto expected = dynamic_classifier(svm::dataset(xs[m]));
+        auto res = fixed_model(xs[m], ws);
+        auto cres = classifier(xs[m]);
+        CHECK(res.second[0] == doctest::Approx(expected.second));
+        CHECK(cres.second == doctest::Approx(expected.second));
+        CHECK(decisions[m][0] == doctest::Approx(expected.second));
+        if (std::abs(expected.second) > 1e-8) {
+            CHECK(res.first == expected.first);
+            CHECK(labels[m] == expected.first);
+        }
+    }
+
+    svm::serialization::model_serializer<svm::ascii_tag, fixed_model_t> saver(fixed_model);
+    saver.save("fixed-dimension-model");
+    fixed_model_t restored_model;
+    svm::serialization::model_serializer<svm::ascii_tag, fixed_model_t> loader(restored_model);
+    loader.load("fixed-dimension-model");
+    // libsvm stores rho and the support vectors with limited precision
+    for (size_t m = 0; m < M; m += 10)
+        CHECK(restored_model(xs[m]).second[0]
+              == doctest::Approx(fixed_model(xs[m]).second[0]).epsilon(1e-2));
+}
+
+TEST_CASE("fixed-dimension-linear") {
+    fixed_dimension_test<svm::kernel::linear>(500, 0.2);
+}
+
+TEST_CASE("fixed-dimension-poly") {
+    fixed_dimension_test<svm::kernel::polynomial<3>>(500, 0.2);
+}
+
+TEST_CASE("fixed-dimension-rbf") {
+    fixed_dimension_test<svm::kernel::rbf>(500, 0.2);
+}
+
+TEST_CASE("fixed-dimension-sigmoid") {
+    fixed_dimension_test<svm::kernel::sigmoid>(500, 0.2);
+}
+
+TEST_CASE("fixed-dimension-mismatch") {
+    using problem_t = svm::problem<svm::kernel::rbf, double, 3>;
+    CHECK_THROWS_AS(problem_t(4), std::invalid_argument);
+    CHECK_THROWS_AS(svm::fixed_dataset<3>({1., 2., 3., 4.}), std::invalid_argument);
+}
+
+// one-class and regression models have no per-class SV counts
+void fixed_dimension_non_classification_test (int svm_type) {
+    const size_t N = 4;
+    const size_t M = 200;
+    using kernel_t = svm::kernel::rbf;
+    using dynamic_model_t = svm::model<kernel_t>;
+    using fixed_model_t = svm::model<kernel_t, double, N>;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform;
+    typename dynamic_model_t::problem_t dynamic_prob(N);
+    typename fixed_model_t::problem_t fixed_prob(N);
+    for (size_t m = 0; m < M; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        double y = x[0] + x[1] * x[2];
+        dynamic_prob.add_sample(svm::dataset(x), y);
+        fixed_prob.add_sample(svm::fixed_dataset<N>(x), y);
+    }
+    svm::parameters<kernel_t> params(0.5);
+    params.svm_params_ptr()->svm_type = svm_type;
+    params.svm_params_ptr()->C = 1;
+    params.svm_params_ptr()->p = 0.1;
+    dynamic_model_t dynamic_model(std::move(dynamic_prob), params);
+    fixed_model_t fixed_model(std::move(fixed_prob), params);
+
+    CHECK(fixed_model.compiled());
+
+    std::vector<svm::fixed_dataset<N>> xs;
+    for (size_t m = 0; m < 50; ++m) {
+        std::vector<double> x(N);
+        for (double & xi : x)
+            xi = uniform(rng);
+        xs.emplace_back(x);
+    }
+    std::vector<double> labels(xs.size());
+    std::vector<std::vector<double>> decisions(xs.size());
+    fixed_model.predict_batch(xs.begin(), xs.end(), labels.begin(), decisions.begin());
+    for (size_t m = 0; m < xs.size(); ++m) {
+        auto expected = dynamic_model(svm::dataset(xs[m]));
+        auto res = fixed_model(xs[m]);
+        CHECK(res.first == doctest::Approx(expected.first));
+        CHECK(res.second[0] == doctest::Approx(expected.second[0]));
+        CHECK(labels[m] == doctest::Approx(expected.first));
+        CHECK(decisions[m][0] == doctest::Approx(expected.second[0]));
+    }
+}
+
+TEST_CASE("fixed-dimension-one-class") {
+    fixed_dimension_non_classification_test(ONE_CLASS);
+}
+
+TEST_CASE("fixed-dimension-epsilon-svr") {
+    fixed_dimension_non_classification_test(EPSILON_SVR);
+}
@@ -21,6 +21,9 @@
 #include "doctest/doctest.h"
 #include "serialization_test.hpp"
 
+#include <random>
+#include <vector>
+
 #include <svm/kernel/linear.hpp>
 #include <svm/kernel/linear_precomputed.hpp>
 #include <svm/serialization/hdf5.hpp>
@@ -34,6 +37,38 @@ TEST_CASE("model-serializer-hdf5-precomputed") {
     model_serializer_test<svm::kernel::linear_precomputed, svm::hdf5_tag>(4, 1000, 0.99, "hdf5-precomputed-model.h5");
 }
 
+TEST_CASE("model-serializer-hdf5-dense-SV") {
+    using kernel_t = svm::kernel::linear;
+    using model_t = svm::model<kernel_t>;
+    const size_t N = 4, M = 1000;
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(N, rng);
+    model_t model(fill_problem<svm::problem<kernel_t>>(M, rng, trial_model),
+                  svm::parameters<kernel_t> {});
+
+    // earlier versions stored the SVs as a dense l x dim matrix
+    std::vector<svm::data_view> svs;
+    for (auto p : model.classifier())
+        svs.push_back(p.second);
+    boost::multi_array<double, 2> SVm(boost::extents[svs.size()][N]);
+    for (size_t i = 0; i < svs.size(); ++i) {
+        size_t j = 0;
+        for (double x : svs[i])
+            SVm[i][j++] = x;
+    }
+    {
+        alps::hdf5::archive ar("hdf5-dense-sv-model.h5", "w");
+        svm::serialization::model_serializer<svm::hdf5_tag, model_t> saver(model);
+        saver.save(ar);
+        ar["SV"] << SVm;
+    }
+
+    model_t restored_model;
+    svm::serialization::model_serializer<svm::hdf5_tag, model_t> loader(restored_model);
+    loader.load("hdf5-dense-sv-model.h5");
+    CHECK(test_model(M, rng, model, restored_model) == doctest::Approx(1.));
+}
+
 TEST_CASE("problem-serializer-hdf5-builtin") {
     problem_serializer_test<svm::kernel::linear, svm::hdf5_tag>(4, 1000, "hdf5-builtin-problem.h5");
 }
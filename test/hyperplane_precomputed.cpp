@@ -23,6 +23,7 @@
 #include "model_test.hpp"
 
 #include <random>
+#include <vector>
 
 #include <svm/kernel/linear_precomputed.hpp>
 
@@ -33,3 +34,73 @@ TEST_CASE("hyperplane-precomputed") {
     model_test<svm::kernel::linear_precomputed>(2500, 0.98, trial_model, rng);
 }
 
+
+TEST_CASE("precomputed-support-vectors") {
+    using kernel_t = svm::kernel::linear_precomputed;
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(5, rng);
+    svm::model<kernel_t> model(
+        fill_problem<svm::problem<kernel_t>>(500, rng, trial_model),
+        svm::parameters<kernel_t>(0.1));
+
+    // the decision function is reproduced from the retained support vectors
+    auto classifier = model.classifier();
+    kernel_t kernel;
+    std::uniform_real_distribution<double> uniform;
+    for (size_t m = 0; m < 20; ++m) {
+        std::vector<double> xs(trial_model.dim());
+        for (double & x : xs)
+            x = uniform(rng);
+        double sum = -classifier.rho();
+        for (auto const& p : classifier)
+            sum += p.first * kernel(p.second, xs);
+        CHECK(classifier(xs).second == doctest::Approx(sum));
+    }
+}
+
+struct counting_kernel : svm::kernel::linear_precomputed {
+    double operator() (input_container_type const& xi,
+                       input_container_type const& xj) const {
+        ++calls;
+        return linear_precomputed::operator()(xi, xj);
+    }
+    static size_t calls;
+};
+
+size_t counting_kernel::calls = 0;
+
+namespace svm {
+    template <>
+    class parameters<counting_kernel>
+        : public parameters<kernel::linear_precomputed>
+    {
+    public:
+        using parameters<kernel::linear_precomputed>::parameters;
+    };
+}
+
+TEST_CASE("precomputed-kernel-calls") {
+    using kernel_t = counting_kernel;
+    std::mt19937 rng(42);
+    hyperplane_model trial_model(5, rng);
+    svm::model<kernel_t> model(
+        fill_problem<svm::problem<kernel_t>>(500, rng, trial_model),
+        svm::parameters<kernel_t>(0.1));
+    size_t nr_sv = model.nSV()[0] + model.nSV()[1];
+    REQUIRE(nr_sv < 500);
+
+    // predictions evaluate the kernel against the support vectors only
+    std::uniform_real_distribution<double> uniform;
+    auto ws = model.workspace();
+    for (size_t m = 0; m < 20; ++m) {
+        std::vector<double> xs(trial_model.dim());
+        for (double & x : xs)
+            x = uniform(rng);
+        counting_kernel::calls = 0;
+        model(xs);
+        CHECK(counting_kernel::calls == nr_sv);
+        counting_kernel::calls = 0;
+        model(xs, ws);
+        CHECK(counting_kernel::calls == nr_sv);
+    }
+}
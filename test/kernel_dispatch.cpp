@@ -0,0 +1,112 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "circle_model.hpp"
+#include "model_test.hpp"
+
+#include <cmath>
+#include <random>
+
+#include <svm/dataset.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/polynomial.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/kernel/sigmoid.hpp>
+
+
+// libsvm's kernel functions, spelled out naively
+double reference_kernel (struct svm_parameter const& p,
+                         svm::data_view x, svm::data_view y)
+{
+    switch (p.kernel_type) {
+    case LINEAR:
+        return x.dot(y);
+    case POLY:
+        return std::pow(p.gamma * x.dot(y) + p.coef0, p.degree);
+    case RBF:
+        return std::exp(-p.gamma * (x.dot(x) + y.dot(y) - 2 * x.dot(y)));
+    case SIGMOID:
+        return std::tanh(p.gamma * x.dot(y) + p.coef0);
+    }
+    throw std::logic_error("unexpected kernel type");
+}
+
+template <class Kernel>
+void kernel_dispatch_test (double gamma = 1.) {
+    svm::parameters<Kernel> params(1., svm::machine_type::C_SVC);
+    params.svm_params_ptr()->gamma = gamma;
+    using model_t = svm::model<Kernel>;
+
+    const size_t M = 400;
+
+    std::mt19937 rng(42);
+    circle_model trial_model(svm::dataset {0.5, 0.5}, 0.3);
+    model_t model(fill_problem<typename model_t::problem_t>(M, rng, trial_model),
+                  params);
+    struct svm_parameter const& p = *params.svm_params_ptr();
+    auto classifier = model.classifier();
+
+    // predictions match the support vector expansion
+    std::uniform_real_distribution<double> uniform;
+    for (size_t m = 0; m < 20; ++m) {
+        svm::dataset x {uniform(rng), uniform(rng)};
+        double sum = -classifier.rho();
+        for (auto const& sv : classifier)
+            sum += sv.first * reference_kernel(p, sv.second, x);
+        CHECK(classifier(x).second == doctest::Approx(sum));
+    }
+
+    // training used the same kernel: unbounded support vectors lie on the
+    // margin up to the stopping tolerance
+    size_t nr_free = 0;
+    for (auto const& sv : classifier) {
+        if (std::abs(sv.first) > p.C * (1 - 1e-8))
+            continue;
+        ++nr_free;
+        double decision = classifier(svm::dataset(sv.second)).second;
+        CHECK(std::abs(decision) == doctest::Approx(1).epsilon(1e-2));
+    }
+    CHECK(nr_free > 0);
+}
+
+TEST_CASE("kernel-dispatch-linear") {
+    kernel_dispatch_test<svm::kernel::linear>();
+}
+
+TEST_CASE("kernel-dispatch-poly") {
+    kernel_dispatch_test<svm::kernel::polynomial<1>>();
+    kernel_dispatch_test<svm::kernel::polynomial<2>>();
+    kernel_dispatch_test<svm::kernel::polynomial<3>>();
+    kernel_dispatch_test<svm::kernel::polynomial<4>>();
+    // degrees beyond 4 are not specialized at compile time
+    kernel_dispatch_test<svm::kernel::polynomial<5>>();
+}
+
+TEST_CASE("kernel-dispatch-rbf") {
+    kernel_dispatch_test<svm::kernel::rbf>(10.);
+}
+
+TEST_CASE("kernel-dispatch-sigmoid") {
+    kernel_dispatch_test<svm::kernel::sigmoid>();
+}
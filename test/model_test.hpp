@@ -96,3 +96,38 @@ void model_test (size_t M, double threshold, TrialModel const& trial_model, RNG_
     std::cout << "success rate: " << 100. * success_rate << "%\n";
     CHECK(success_rate > threshold);
 }
+
+// trains a model on the same problem of M samples twice, calling
+// setup(params, run) before run 0 and run 1, and checks that both runs
+// arrive at identical models
+template <class Kernel, class TrialModel, class Setup>
+void identical_training_test (size_t M, TrialModel const& trial_model,
+                              svm::parameters<Kernel> params, Setup setup)
+{
+    using model_t = svm::model<Kernel>;
+    using input_t = typename model_t::input_container_type;
+
+    auto train = [&] (int run) {
+        std::mt19937 rng(42);
+        setup(params, run);
+        return model_t(fill_problem<typename model_t::problem_t>(M, rng, trial_model),
+                       params);
+    };
+    model_t model_a = train(0);
+    model_t model_b = train(1);
+
+    CHECK(model_b.nSV() == model_a.nSV());
+    CHECK(model_b.rho() == model_a.rho());
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> uniform;
+    for (size_t m = 0; m < 100; ++m) {
+        std::vector<double> xs(trial_model.dim());
+        for (double & x : xs)
+            x = uniform(rng);
+        auto res_a = model_a(input_t(xs));
+        auto res_b = model_b(input_t(xs));
+        CHECK(res_b.first == res_a.first);
+        CHECK(res_b.second == res_a.second);
+    }
+}
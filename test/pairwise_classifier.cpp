@@ -0,0 +1,106 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/linear.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+template <class Kernel>
+void pairwise_test (bool compile) {
+    using model_t = svm::model<Kernel>;
+    using C = typename model_t::input_container_type;
+
+    const size_t M = 600;
+    const size_t N = 5;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    auto prob = sector_problem<typename model_t::problem_t>(M, N, rng);
+    model_t model(std::move(prob), svm::parameters<Kernel> {});
+    if (compile)
+        model.compile();
+    auto const classifiers = model.classifiers();
+    REQUIRE(classifiers.size() == N * (N - 1) / 2);
+
+    auto ws = model.workspace();
+    auto shared = model.workspace();
+    for (size_t i = 0; i < 50; ++i) {
+        C x {uniform(rng), uniform(rng)};
+        auto expected = model(x);
+        model.kernel_values(x, shared);
+        for (size_t c = 0; c < classifiers.size(); ++c) {
+            auto labels = classifiers[c].labels();
+            auto winner = expected.second[c] > 0 ? labels.first : labels.second;
+
+            auto res = classifiers[c].pairwise(x, ws);
+            CHECK(res.second == doctest::Approx(expected.second[c]));
+            auto res_shared = classifiers[c].pairwise(shared);
+            CHECK(res_shared.second == doctest::Approx(expected.second[c]));
+            if (std::abs(expected.second[c]) > 1e-8) {
+                CHECK(res.first == winner);
+                CHECK(res_shared.first == winner);
+            }
+
+            // the call operator still reports the label voted for by the model
+            auto res_model = classifiers[c](x, ws);
+            CHECK(res_model.first == expected.first);
+            CHECK(res_model.second == doctest::Approx(expected.second[c]));
+        }
+    }
+
+    // kernel values which were never computed, or which were overwritten by
+    // another evaluation, are rejected
+    auto fresh = model.workspace();
+    CHECK_THROWS_AS(classifiers[0].pairwise(fresh), std::logic_error);
+    C x {uniform(rng), uniform(rng)};
+    model.kernel_values(x, shared);
+    CHECK_NOTHROW(classifiers[0].pairwise(shared));
+    classifiers[1].pairwise(x, shared);
+    CHECK_THROWS_AS(classifiers[0].pairwise(shared), std::logic_error);
+    model_t other(sector_problem<typename model_t::problem_t>(M, N, rng),
+                  svm::parameters<Kernel> {});
+    other.kernel_values(x, shared);
+    CHECK_THROWS_AS(classifiers[0].pairwise(shared), std::logic_error);
+}
+
+TEST_CASE("pairwise-rbf") {
+    pairwise_test<svm::kernel::rbf>(false);
+}
+
+TEST_CASE("pairwise-rbf-compiled") {
+    pairwise_test<svm::kernel::rbf>(true);
+}
+
+TEST_CASE("pairwise-linear") {
+    pairwise_test<svm::kernel::linear>(false);
+}
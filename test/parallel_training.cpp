@@ -0,0 +1,45 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "circle_model.hpp"
+#include "model_test.hpp"
+
+#include <svm/dataset.hpp>
+#include <svm/parameters.hpp>
+#include <svm/kernel/rbf.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+TEST_CASE("parallel-binary-training") {
+    // long enough for the kernel columns to be filled in parallel; each
+    // kernel value is computed the same way by whichever thread, so the
+    // solver takes the same steps
+    identical_training_test(3000, circle_model(svm::dataset {0.5, 0.5}, 0.3),
+                            svm::parameters<svm::kernel::rbf> {},
+                            [] (svm::parameters<svm::kernel::rbf> &, int run) {
+#ifdef _OPENMP
+                                omp_set_num_threads(run == 0 ? 1 : 4);
+#endif
+                            });
+}
@@ -0,0 +1,111 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+// count heap allocations by interposing malloc, which is also what
+// operator new and the libsvm code end up calling
+#ifdef __GLIBC__
+extern "C" void * __libc_malloc (size_t);
+
+static size_t nr_allocs = 0;
+
+extern "C" void * malloc (size_t size) {
+    ++nr_allocs;
+    return __libc_malloc(size);
+}
+#endif
+
+template <class Label>
+void workspace_test (size_t N) {
+    using cmplx = std::complex<double>;
+    using kernel_t = svm::kernel::rbf;
+    using problem_t = svm::problem<kernel_t, Label>;
+    using model_t = svm::model<kernel_t, Label>;
+    using C = typename problem_t::input_container_type;
+
+    const size_t M = 1000;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    auto prob = sector_problem<problem_t>(M, N, rng);
+    model_t model(std::move(prob), svm::parameters<kernel_t> {});
+    CHECK(model.nr_labels() == N);
+
+    std::vector<C> xs;
+    for (size_t i = 0; i < M; ++i) {
+        cmplx c {uniform(rng), uniform(rng)};
+        xs.push_back(C {c.real(), c.imag()});
+    }
+
+    auto ws = model.workspace();
+    for (C const& x : xs) {
+        auto res = model(x);
+        auto res_ws = model(x, ws);
+        CHECK(res.first == res_ws.first);
+        CHECK(res.second == res_ws.second);
+    }
+
+    // default-constructed workspaces and those of other models are resized
+    problem_t small_prob(2);
+    for (size_t i = 0; i < 50; ++i)
+        small_prob.add_sample(xs[i], i % 2);
+    model_t small_model(std::move(small_prob), svm::parameters<kernel_t> {});
+    typename model_t::predict_workspace default_ws;
+    auto other_ws = small_model.workspace();
+    for (size_t i = 0; i < 10; ++i) {
+        auto res = model(xs[i]);
+        auto res_default = model(xs[i], default_ws);
+        CHECK(res.first == res_default.first);
+        CHECK(res.second == res_default.second);
+        auto res_other = model(xs[i], other_ws);
+        CHECK(res.first == res_other.first);
+        CHECK(res.second == res_other.second);
+    }
+
+#ifdef __GLIBC__
+    size_t allocs_before = nr_allocs;
+    for (C const& x : xs)
+        model(x, ws);
+    CHECK(nr_allocs == allocs_before);
+#endif
+}
+
+TEST_CASE("workspace-binary") {
+    workspace_test<double>(2);
+}
+
+TEST_CASE("workspace-dynamic") {
+    workspace_test<double>(5);
+}
@@ -100,6 +100,41 @@ TEST_CASE("problem-map-append") {
     CHECK(c.size() == 0);
 }
 
+TEST_CASE("problem-csr-storage") {
+    using problem_t = svm::problem<svm::kernel::linear, int>;
+
+    problem_t a(3), b(3);
+    for (int i = 0; i < 42; ++i) {
+        svm::dataset x {double(i % 2), 0., double(i + 1)};
+        a.add_sample(x, i);
+        b.add_sample(std::move(x), i);
+    }
+    for (int i = 0; i < 42; ++i) {
+        svm::data_view x = a.view(i).first;
+        CHECK(std::vector<double>(x.begin(), x.end())
+              == std::vector<double> {double(i % 2), 0., double(i + 1)});
+    }
+
+    // samples are laid out back to back
+    struct svm_problem p = a.generate();
+    REQUIRE(p.l == 42);
+    for (int i = 1; i < p.l; ++i) {
+        struct svm_node const * prev = p.x[i-1];
+        while (prev->index != -1)
+            ++prev;
+        CHECK(p.x[i] == prev + 1);
+    }
+
+    problem_t c(std::move(b), [] (int i) { return i % 3; }, [] (int l) { return l != 1; });
+    CHECK(b.size() == 0);
+    REQUIRE(c.size() == 28);
+    for (size_t i = 0; i < c.size(); ++i) {
+        int orig = 3 * (i / 2) + 2 * (i % 2);
+        CHECK(c[i].second == orig % 3);
+        CHECK(c.view(i).first.dot(a.view(orig).first) == doctest::Approx(a.view(orig).first.dot(a.view(orig).first)));
+    }
+}
+
 SVM_LABEL_BEGIN(binary_class, 2)
 SVM_LABEL_ADD(WHITE)
 SVM_LABEL_ADD(BLACK)
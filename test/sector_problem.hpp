@@ -0,0 +1,45 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <random>
+
+
+// multiclass toy problem: points drawn uniformly from [-1,1]^2 are labeled
+// by which of N equal angular sectors around the origin they fall into
+inline int sector_label (double x, double y, size_t N) {
+    return std::floor((std::arg(std::complex<double>(x, y)) / M_PI + 1) * N / 2);
+}
+
+template <class Problem, class RNG_t>
+Problem sector_problem (size_t M, size_t N, RNG_t & rng) {
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    Problem prob(2);
+    using input_t = typename Problem::input_container_type;
+    using label_t = typename Problem::label_type;
+
+    for (size_t m = 0; m < M; ++m) {
+        double x = uniform(rng);
+        double y = uniform(rng);
+        prob.add_sample(input_t {x, y}, label_t(sector_label(x, y, N)));
+    }
+    return prob;
+}
@@ -0,0 +1,110 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+#include "sector_problem.hpp"
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <svm/label.hpp>
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+
+
+SVM_LABEL_BEGIN(three, 3)
+SVM_LABEL_ADD(A)
+SVM_LABEL_ADD(B)
+SVM_LABEL_ADD(C)
+SVM_LABEL_END()
+
+SVM_LABEL_BEGIN(five, 5)
+SVM_LABEL_ADD(A)
+SVM_LABEL_ADD(B)
+SVM_LABEL_ADD(C)
+SVM_LABEL_ADD(D)
+SVM_LABEL_ADD(E)
+SVM_LABEL_END()
+
+// the statically unrolled voting has to agree with libsvm's, which is used
+// for dynamic labels, including the tie-breaking
+template <class Label, size_t N>
+void static_voting_test (bool compile) {
+    using kernel_t = svm::kernel::rbf;
+    using static_model_t = svm::model<kernel_t, Label>;
+    using dynamic_model_t = svm::model<kernel_t>;
+    using C = typename dynamic_model_t::input_container_type;
+
+    const size_t M = 1000;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    typename static_model_t::problem_t static_prob(2);
+    typename dynamic_model_t::problem_t dynamic_prob(2);
+    for (size_t i = 0; i < M; ++i) {
+        double x = uniform(rng);
+        double y = uniform(rng);
+        int l = sector_label(x, y, N);
+        static_prob.add_sample(C {x, y}, Label(l));
+        dynamic_prob.add_sample(C {x, y}, l);
+    }
+    svm::parameters<kernel_t> params(0.2);
+    static_model_t static_model(std::move(static_prob), params);
+    dynamic_model_t dynamic_model(std::move(dynamic_prob), params);
+    if (compile) {
+        static_model.compile();
+        dynamic_model.compile();
+    }
+
+    std::vector<C> xs;
+    for (size_t i = 0; i < M; ++i)
+        xs.push_back(C {uniform(rng), uniform(rng)});
+    std::vector<Label> labels(M);
+    std::vector<typename static_model_t::decision_type> decisions(M);
+    static_model.predict_batch(xs.begin(), xs.end(), labels.begin(), decisions.begin());
+
+    for (size_t i = 0; i < M; ++i) {
+        auto res = static_model(xs[i]);
+        auto expected = dynamic_model(xs[i]);
+        CHECK(double(res.first) == expected.first);
+        CHECK(double(labels[i]) == expected.first);
+        for (size_t c = 0; c < N * (N - 1) / 2; ++c) {
+            CHECK(res.second[c] == doctest::Approx(expected.second[c]));
+            CHECK(decisions[i][c] == doctest::Approx(expected.second[c]));
+        }
+    }
+}
+
+TEST_CASE("static-voting-3") {
+    static_voting_test<three::label, 3>(false);
+}
+
+TEST_CASE("static-voting-5") {
+    static_voting_test<five::label, 5>(false);
+}
+
+TEST_CASE("static-voting-5-compiled") {
+    static_voting_test<five::label, 5>(true);
+}
@@ -25,9 +25,9 @@
 
 using svm::detail::basic_problem;
 
-template <class Container, class Label>
-void test_problems_equal(basic_problem<Container, Label> const& lhs,
-                         basic_problem<Container, Label> const& rhs)
+template <class Container, class Label, class Storage>
+void test_problems_equal(basic_problem<Container, Label, Storage> const& lhs,
+                         basic_problem<Container, Label, Storage> const& rhs)
 {
     CHECK(lhs.dim() == rhs.dim());
     CHECK(lhs.size() == rhs.size());
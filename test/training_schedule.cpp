@@ -0,0 +1,112 @@
+/*   Support Vector Machine Library Wrappers
+ *   Copyright (C) 2018-2019  Jonas Greitemann
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program, see the file entitled "LICENCE" in the
+ *   repository's root directory, or see <http://www.gnu.org/licenses/>.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest/doctest.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <svm/model.hpp>
+#include <svm/parameters.hpp>
+#include <svm/problem.hpp>
+#include <svm/kernel/rbf.hpp>
+#include <svm/libsvm/svm.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+struct pair_report {
+    int label_i, label_j, l;
+    double start, end;
+};
+
+std::vector<pair_report> reports;
+
+void training_report_test (bool probability) {
+    using model_t = svm::model<svm::kernel::rbf>;
+    using C = typename model_t::input_container_type;
+
+    const size_t N = 4;
+    const size_t counts[N] = {30, 120, 60, 90};
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+
+    model_t::problem_t prob(2);
+    for (size_t k = 0; k < N; ++k)
+        for (size_t i = 0; i < counts[k]; ++i)
+            prob.add_sample(C {uniform(rng) + k, uniform(rng)}, k);
+    svm::parameters<svm::kernel::rbf> params;
+    params.svm_params_ptr()->probability = probability;
+
+    // a single thread dispatches the subproblems strictly in order
+#ifdef _OPENMP
+    int nr_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    reports.clear();
+    svm_set_train_report_function([] (int label_i, int label_j, int l,
+                                      double start, double end) {
+        reports.push_back({label_i, label_j, l, start, end});
+    });
+    auto begin = std::chrono::steady_clock::now();
+    model_t model(std::move(prob), params);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    svm_set_train_report_function(nullptr);
+#ifdef _OPENMP
+    omp_set_num_threads(nr_threads);
+#endif
+
+    // one report per pair of the original labels, none for the models fitted
+    // for the probability estimates
+    REQUIRE(reports.size() == N * (N - 1) / 2);
+    std::vector<std::vector<int>> seen(N, std::vector<int>(N, 0));
+    for (auto const& r : reports) {
+        REQUIRE(r.label_i >= 0);
+        REQUIRE(r.label_j < int(N));
+        ++seen[r.label_i][r.label_j];
+        ++seen[r.label_j][r.label_i];
+        CHECK(size_t(r.l) == counts[r.label_i] + counts[r.label_j]);
+        CHECK(r.start >= 0);
+        CHECK(r.end >= r.start);
+        CHECK(r.end <= elapsed.count());
+    }
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+            CHECK(seen[i][j] == (i == j ? 0 : 1));
+
+    // the largest subproblems are dispatched first, each after the previous
+    // one has finished
+    for (size_t k = 1; k < reports.size(); ++k) {
+        CHECK(reports[k].l <= reports[k-1].l);
+        CHECK(reports[k].start >= reports[k-1].end);
+    }
+}
+
+TEST_CASE("training-schedule") {
+    training_report_test(false);
+}
+
+TEST_CASE("training-schedule-probability") {
+    training_report_test(true);
+}